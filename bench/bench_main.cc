@@ -0,0 +1,18 @@
+// Copyright 2025 RocketFS
+
+#include <benchmark/benchmark.h>
+#include <gflags/gflags.h>
+#include <quill/core/LogLevel.h>
+
+#include "common/logger.h"
+
+int main(int argc, char** argv) {
+  // `--benchmark_*` flags are consumed first, the rest are RocketFS flags.
+  benchmark::Initialize(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  // Per-txn debug logs would dominate the measured latency.
+  rocketfs::logger->set_log_level(quill::LogLevel::Warning);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
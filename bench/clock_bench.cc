@@ -0,0 +1,45 @@
+// Copyright 2025 RocketFS
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "common/clock_service.h"
+#include "common/time_util.h"
+
+namespace rocketfs {
+namespace {
+
+void BM_TimeUtil_NowNs(benchmark::State& state) {
+  static TimeUtil time_util;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(time_util.NowNs());
+  }
+}
+BENCHMARK(BM_TimeUtil_NowNs)->ThreadRange(1, 64);
+
+std::unique_ptr<ClockService> clock_service;
+
+void SetUp(const benchmark::State&) {
+  clock_service = std::make_unique<ClockService>();
+  clock_service->Start();
+}
+
+void TearDown(const benchmark::State&) {
+  clock_service->Stop();
+  clock_service.reset();
+}
+
+// The ticker keeps writing the cached time while threads read it.
+void BM_ClockService_NowNs(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(clock_service->NowNs());
+  }
+}
+BENCHMARK(BM_ClockService_NowNs)
+    ->Setup(SetUp)
+    ->Teardown(TearDown)
+    ->ThreadRange(1, 64);
+
+}  // namespace
+}  // namespace rocketfs
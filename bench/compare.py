@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+# Copyright 2025 RocketFS
+"""Compares two `rocketfs_bench` JSON outputs and flags regressions.
+
+Produce the inputs with
+  ./rocketfs_bench --benchmark_out=<file> --benchmark_out_format=json
+and run
+  bench/compare.py before.json after.json [--threshold=0.1]
+It exits with 1 if any benchmark got slower by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        results = json.load(f)["benchmarks"]
+    # Aggregates, e.g., `_mean` and `_stddev` rows from `--benchmark_repetitions`,
+    # are skipped unless they are all there is.
+    iterations = [r for r in results if r.get("run_type") != "aggregate"]
+    return {r["name"]: r for r in (iterations or results)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("before")
+    parser.add_argument("after")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="The relative slowdown of real time above which a benchmark "
+        "counts as regressed.",
+    )
+    args = parser.parse_args()
+
+    before = load(args.before)
+    after = load(args.after)
+    regressed = []
+    print(f"{'Benchmark':<64} {'Before':>12} {'After':>12} {'Change':>8}")
+    for name, new in after.items():
+        old = before.get(name)
+        if old is None:
+            print(f"{name:<64} {'-':>12} {new['real_time']:>12.1f} {'new':>8}")
+            continue
+        if old["time_unit"] != new["time_unit"]:
+            print(f"{name:<64} time units differ, skipped")
+            continue
+        change = (new["real_time"] - old["real_time"]) / old["real_time"]
+        mark = ""
+        if change > args.threshold:
+            regressed.append(name)
+            mark = " !"
+        print(
+            f"{name:<64} {old['real_time']:>12.1f} {new['real_time']:>12.1f} "
+            f"{change:>+8.1%}{mark}"
+        )
+    for name in before.keys() - after.keys():
+        print(f"{name:<64} {before[name]['real_time']:>12.1f} {'-':>12} "
+              f"{'removed':>8}")
+
+    if regressed:
+        print(f"\n{len(regressed)} benchmark(s) regressed by more than "
+              f"{args.threshold:.0%}:")
+        for name in regressed:
+            print(f"  {name}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
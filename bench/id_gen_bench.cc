@@ -0,0 +1,82 @@
+// Copyright 2025 RocketFS
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+
+#include "common/status.h"
+#include "namenode/common/leased_id_gen.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+namespace {
+
+constexpr auto kIterationsPerThread = 100'000;
+constexpr uint64_t kBlockSize = 4096;
+
+// Stands in for `KVIDLeaser` without the fsync per lease, so only contention
+// is measured.
+class InMemoryIDLeaser : public IDLeaserBase {
+ public:
+  InMemoryIDLeaser() = default;
+  InMemoryIDLeaser(const InMemoryIDLeaser&) = delete;
+  InMemoryIDLeaser(InMemoryIDLeaser&&) = delete;
+  InMemoryIDLeaser& operator=(const InMemoryIDLeaser&) = delete;
+  InMemoryIDLeaser& operator=(InMemoryIDLeaser&&) = delete;
+  ~InMemoryIDLeaser() override = default;
+
+  std::expected<uint64_t, Status> Lease(uint64_t count) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    leases_++;
+    auto first = hwm_;
+    hwm_ += count;
+    return first;
+  }
+
+  uint64_t GetLeases() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return leases_;
+  }
+
+ private:
+  std::mutex mutex_;
+  uint64_t hwm_{kRootInodeID.val + 1};
+  uint64_t leases_{0};
+};
+
+std::unique_ptr<InMemoryIDLeaser> leaser;
+std::unique_ptr<LeasedIDGen<InodeID>> leased_id_gen;
+
+void SetUp(const benchmark::State&) {
+  leaser = std::make_unique<InMemoryIDLeaser>();
+  leased_id_gen =
+      std::make_unique<LeasedIDGen<InodeID>>(leaser.get(), kBlockSize);
+}
+
+void TearDown(const benchmark::State&) {
+  leased_id_gen.reset();
+  leaser.reset();
+}
+
+// Threads only meet in the leaser, once every `kBlockSize` IDs.
+void BM_LeasedIDGen_Next(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(leased_id_gen->Next());
+  }
+  if (state.thread_index() == 0) {
+    state.counters["leases"] = static_cast<double>(leaser->GetLeases());
+  }
+}
+BENCHMARK(BM_LeasedIDGen_Next)
+    ->Setup(SetUp)
+    ->Teardown(TearDown)
+    ->Iterations(kIterationsPerThread)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace rocketfs
@@ -0,0 +1,46 @@
+// Copyright 2025 RocketFS
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+#include "namenode/common/req_arena.h"
+#include "namenode/common/req_scoped_alloc.h"
+
+namespace rocketfs {
+namespace {
+
+constexpr size_t kArenaBytes = 4096;
+
+// Stands in for the allocations of a req, `state.range(0)` bytes in total.
+void AllocateLikeAReq(benchmark::State& state, ReqScopedAlloc alloc) {
+  for (int64_t bytes = 0; bytes < state.range(0); bytes += 64) {
+    std::pmr::string s(48, 'x', alloc);
+    benchmark::DoNotOptimize(s.data());
+  }
+}
+
+// What `HandlerCtx` did before arenas were pooled.
+void BM_MonotonicBufferResource(benchmark::State& state) {
+  for (auto _ : state) {
+    auto buf = std::make_unique<std::byte[]>(kArenaBytes);
+    std::pmr::monotonic_buffer_resource arena(buf.get(), kArenaBytes);
+    AllocateLikeAReq(state, ReqScopedAlloc(&arena));
+  }
+}
+BENCHMARK(BM_MonotonicBufferResource)->Range(1024, 256 * 1024);
+
+void BM_ReqArena(benchmark::State& state) {
+  static ArenaSizer arena_sizer("Bench");
+  for (auto _ : state) {
+    ReqArena arena(&arena_sizer);
+    AllocateLikeAReq(state, ReqScopedAlloc(&arena));
+  }
+}
+BENCHMARK(BM_ReqArena)->Range(1024, 256 * 1024);
+
+}  // namespace
+}  // namespace rocketfs
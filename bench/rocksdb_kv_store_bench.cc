@@ -0,0 +1,193 @@
+// Copyright 2025 RocketFS
+
+#include <benchmark/benchmark.h>
+#include <fmt/core.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <unifex/sync_wait.hpp>
+
+#include "common/logger.h"
+#include "common/status.h"
+#include "namenode/common/req_scoped_alloc.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+#include "namenode/table/kv/column_family.h"
+#include "namenode/table/kv/kv_store_base.h"
+#include "namenode/table/kv/rocksdb_kv_store.h"
+#include "namenode/table/kv/serde.h"
+
+namespace rocketfs {
+namespace {
+
+constexpr InodeID kBenchParentID{2};
+constexpr uint64_t kBenchEntries = 1 << 16;
+constexpr uint64_t kFirstBenchInodeID = 1ULL << 40;
+constexpr uint64_t kPopulateBatch = 1024;
+
+std::string BenchName(uint64_t i) {
+  return fmt::format("dir-{:010}", i);
+}
+
+Dir MakeDir(uint64_t i, ReqScopedAlloc alloc) {
+  return Dir{.parent_id = kBenchParentID,
+             .name = std::pmr::string(BenchName(i), alloc),
+             .id = InodeID{kFirstBenchInodeID + i},
+             .acl = {.uid = 1000, .gid = 1000, .perm = 0755}};
+}
+
+void Commit(KVStoreBase* kv_store, std::unique_ptr<TxnBase> txn) {
+  auto committed = unifex::sync_wait(kv_store->CommitTxn(std::move(txn)));
+  CHECK(committed && *committed);
+}
+
+// A temp database shared by every benchmark in this file, holding
+// `kBenchEntries` dir entries under `kBenchParentID`. It is removed at exit.
+class BenchKVStore {
+ public:
+  BenchKVStore()
+      : path_(std::filesystem::temp_directory_path() /
+              fmt::format("rocketfs_bench_{}", getpid())) {
+    std::filesystem::remove_all(path_);
+    std::filesystem::create_directories(path_);
+    kv_store_ = std::make_unique<RocksDBKVStore>(path_.string());
+    for (uint64_t i = 0; i < kBenchEntries; i += kPopulateBatch) {
+      std::pmr::monotonic_buffer_resource arena;
+      ReqScopedAlloc alloc(&arena);
+      auto txn = kv_store_->StartTxn(alloc);
+      DEntSerde serde(alloc);
+      for (uint64_t j = i; j < i + kPopulateBatch; j++) {
+        auto dir = MakeDir(j, alloc);
+        txn->Put(kDEntCFIndex, serde.SerKey(dir), serde.SerVal(dir));
+      }
+      Commit(kv_store_.get(), std::move(txn));
+    }
+  }
+  BenchKVStore(const BenchKVStore&) = delete;
+  BenchKVStore(BenchKVStore&&) = delete;
+  BenchKVStore& operator=(const BenchKVStore&) = delete;
+  BenchKVStore& operator=(BenchKVStore&&) = delete;
+  ~BenchKVStore() {
+    kv_store_.reset();
+    std::filesystem::remove_all(path_);
+  }
+
+  KVStoreBase* Get() {
+    return kv_store_.get();
+  }
+
+ private:
+  std::filesystem::path path_;
+  std::unique_ptr<KVStoreBase> kv_store_;
+};
+
+KVStoreBase* GetBenchKVStore() {
+  static BenchKVStore bench_kv_store;
+  return bench_kv_store.Get();
+}
+
+void BM_RocksDBKVStore_StartTxn(benchmark::State& state) {
+  auto* kv_store = GetBenchKVStore();
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena;
+    benchmark::DoNotOptimize(kv_store->StartTxn(ReqScopedAlloc(&arena)));
+  }
+}
+BENCHMARK(BM_RocksDBKVStore_StartTxn);
+
+// Includes `StartTxn`, see `BM_RocksDBKVStore_StartTxn`.
+void BM_RocksDBTxn_Get(benchmark::State& state) {
+  auto* kv_store = GetBenchKVStore();
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<uint64_t> dist(0, kBenchEntries - 1);
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena;
+    ReqScopedAlloc alloc(&arena);
+    auto txn = kv_store->StartTxn(alloc);
+    auto val = unifex::sync_wait(txn->Get(
+        kDEntCFIndex,
+        DEntSerde(alloc).SerKey(kBenchParentID, BenchName(dist(rng)))));
+    CHECK(val && *val && **val);
+  }
+}
+BENCHMARK(BM_RocksDBTxn_Get)->ThreadRange(1, 16)->UseRealTime();
+
+// Includes `StartTxn`. The arg is the num of entries fetched.
+void BM_RocksDBTxn_GetRange(benchmark::State& state) {
+  auto* kv_store = GetBenchKVStore();
+  auto limit = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena;
+    ReqScopedAlloc alloc(&arena);
+    auto txn = kv_store->StartTxn(alloc);
+    DEntSerde serde(alloc);
+    auto vals = unifex::sync_wait(
+        txn->GetRange(kDEntCFIndex,
+                      serde.SerKey(kBenchParentID, ""),
+                      serde.SerKey(kBenchParentID, "\xFF"),
+                      limit));
+    CHECK(vals && *vals && (*vals)->size() == limit);
+  }
+  state.SetItemsProcessed(state.iterations() * limit);
+}
+BENCHMARK(BM_RocksDBTxn_GetRange)->RangeMultiplier(8)->Range(1, 4096);
+
+// Every txn writes a dir entry that no other txn writes.
+void BM_RocksDBKVStore_CommitTxn(benchmark::State& state) {
+  auto* kv_store = GetBenchKVStore();
+  static std::atomic<uint64_t> next_entry = kBenchEntries;
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena;
+    ReqScopedAlloc alloc(&arena);
+    auto txn = kv_store->StartTxn(alloc);
+    DEntSerde serde(alloc);
+    auto dir = MakeDir(next_entry.fetch_add(1), alloc);
+    txn->Put(kDEntCFIndex, serde.SerKey(dir), serde.SerVal(dir));
+    Commit(kv_store, std::move(txn));
+  }
+}
+BENCHMARK(BM_RocksDBKVStore_CommitTxn)->ThreadRange(1, 16)->UseRealTime();
+
+// Every txn reads and rewrites one of `state.range(0)` hot entries, so the
+// conflict detector is contended both on its mutex and on overlapping keys.
+void BM_RocksDBConflictDetector_Contention(benchmark::State& state) {
+  auto* kv_store = GetBenchKVStore();
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<uint64_t> dist(0, state.range(0) - 1);
+  uint64_t conflicts = 0;
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena;
+    ReqScopedAlloc alloc(&arena);
+    auto txn = kv_store->StartTxn(alloc);
+    DEntSerde serde(alloc);
+    auto dir = MakeDir(dist(rng), alloc);
+    auto val = unifex::sync_wait(txn->Get(kDEntCFIndex, serde.SerKey(dir)));
+    CHECK(val && *val);
+    txn->Put(kDEntCFIndex, serde.SerKey(dir), serde.SerVal(dir));
+    auto committed = unifex::sync_wait(kv_store->CommitTxn(std::move(txn)));
+    CHECK(committed);
+    if (!*committed) {
+      // Only conflicts are expected, anything else is a bug.
+      CHECK(committed->error().GetCode() == StatusCode::kConflictError);
+      conflicts++;
+    }
+  }
+  state.counters["conflicts"] = benchmark::Counter(
+      static_cast<double>(conflicts), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RocksDBConflictDetector_Contention)
+    ->ArgsProduct({{1, 64, 4096}})
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace rocketfs
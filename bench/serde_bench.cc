@@ -0,0 +1,103 @@
+// Copyright 2025 RocketFS
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "namenode/common/req_scoped_alloc.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/hard_link_table_base.h"
+#include "namenode/table/inode_id.h"
+#include "namenode/table/kv/kv_dent_views.h"
+#include "namenode/table/kv/kv_key.h"
+#include "namenode/table/kv/serde.h"
+
+namespace rocketfs {
+namespace {
+
+constexpr size_t kArenaBytes = 4096;
+
+Dir MakeDir(ReqScopedAlloc alloc) {
+  constexpr int64_t kNowNs = 1'742'256'000'000'000'000;
+  return Dir{.parent_id = InodeID{1},
+             .name = std::pmr::string("a-typical-directory-name", alloc),
+             .id = InodeID{1ULL << 40},
+             .acl = {.uid = 1000, .gid = 1000, .perm = 0755},
+             .ctime_in_ns = kNowNs,
+             .mtime_in_ns = kNowNs,
+             .atime_in_ns = kNowNs};
+}
+
+template <typename Serde>
+std::string SerDir() {
+  std::pmr::monotonic_buffer_resource arena;
+  ReqScopedAlloc alloc(&arena);
+  return std::string(Serde(alloc).SerVal(MakeDir(alloc)));
+}
+
+// Every iteration runs in a fresh arena, as a req would.
+template <typename Serde, typename Fn>
+void RunInArena(benchmark::State& state, Fn&& fn) {
+  std::array<std::byte, kArenaBytes> buf;
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena(buf.data(), buf.size());
+    ReqScopedAlloc alloc(&arena);
+    Serde serde(alloc);
+    fn(serde, alloc);
+  }
+}
+
+void BM_InodeSerde_SerVal(benchmark::State& state) {
+  RunInArena<InodeSerde>(state, [](auto& serde, ReqScopedAlloc alloc) {
+    benchmark::DoNotOptimize(serde.SerVal(MakeDir(alloc)));
+  });
+}
+BENCHMARK(BM_InodeSerde_SerVal);
+
+void BM_InodeSerde_DeVal(benchmark::State& state) {
+  auto val = SerDir<InodeSerde>();
+  RunInArena<InodeSerde>(state, [&val](auto& serde, ReqScopedAlloc) {
+    benchmark::DoNotOptimize(serde.DeVal(val));
+  });
+}
+BENCHMARK(BM_InodeSerde_DeVal);
+
+void BM_DEntSerde_SerVal(benchmark::State& state) {
+  RunInArena<DEntSerde>(state, [](auto& serde, ReqScopedAlloc alloc) {
+    benchmark::DoNotOptimize(serde.SerVal(MakeDir(alloc)));
+  });
+}
+BENCHMARK(BM_DEntSerde_SerVal);
+
+void BM_DEntSerde_DeVal(benchmark::State& state) {
+  auto val = SerDir<DEntSerde>();
+  RunInArena<DEntSerde>(state, [&val](auto& serde, ReqScopedAlloc) {
+    benchmark::DoNotOptimize(serde.DeVal(val));
+  });
+}
+BENCHMARK(BM_DEntSerde_DeVal);
+
+void BM_DEntSerde_DeView(benchmark::State& state) {
+  auto val = SerDir<DEntSerde>();
+  RunInArena<DEntSerde>(state, [&val](auto& serde, ReqScopedAlloc) {
+    auto view = serde.DeView(val);
+    benchmark::DoNotOptimize(std::get<KVDirView>(view).GetName());
+  });
+}
+BENCHMARK(BM_DEntSerde_DeView);
+
+void BM_DEntSerde_SerKey(benchmark::State& state) {
+  RunInArena<DEntSerde>(state, [](auto& serde, ReqScopedAlloc) {
+    benchmark::DoNotOptimize(
+        serde.SerKey(InodeID{1}, "a-typical-directory-name").View());
+  });
+}
+BENCHMARK(BM_DEntSerde_SerKey);
+
+}  // namespace
+}  // namespace rocketfs
@@ -1,5 +1,6 @@
 find_package(absl CONFIG REQUIRED)
 find_package(asio-grpc CONFIG REQUIRED)
+find_package(benchmark CONFIG REQUIRED)
 find_package(OpenSSL CONFIG REQUIRED)
 find_package(CURL CONFIG REQUIRED)
 find_package(flatbuffers CONFIG REQUIRED)
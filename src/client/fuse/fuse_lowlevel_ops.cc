@@ -50,12 +50,22 @@ const struct fuse_lowlevel_ops gFuseLowlevelOps = {
            size_t size,
            off_t off,
            struct fuse_file_info* fi) {
-          gFuseOpsProxy->CreateOp<FuseReadDirOp>(req, ino, size, off, fi);
+          gFuseOpsProxy->CreateOp<FuseReadDirOp>(
+              req, ino, size, off, fi, /*plus=*/false);
         },
     .releasedir =
         [](fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi) {
           gFuseOpsProxy->CreateOp<FuseRelDirOp>(req, ino, fi);
         },
+    .readdirplus =
+        [](fuse_req_t req,
+           fuse_ino_t ino,
+           size_t size,
+           off_t off,
+           struct fuse_file_info* fi) {
+          gFuseOpsProxy->CreateOp<FuseReadDirOp>(
+              req, ino, size, off, fi, /*plus=*/true);
+        },
 };
 
 }  // namespace rocketfs
@@ -39,6 +39,10 @@ int main(int argc, char* argv[]) {
       .entry_generation = 0,
       .attr_timeout_sec = 0.0,
       .entry_timeout_sec = 0.0,
+      .throttled_max_retries = 8,
+      .throttled_backoff_base_ms = 10,
+      .throttled_backoff_max_ms = 1000,
+      .list_dir_page_entries = 1000,
   };
   rocketfs::gFuseOpsProxy =
       std::make_unique<rocketfs::FuseOpsProxy>(fuse_options);
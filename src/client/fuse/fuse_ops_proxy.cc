@@ -8,6 +8,7 @@
 #include <grpcpp/support/status.h>
 #include <quill/LogMacros.h>
 #include <quill/core/ThreadContextManager.h>
+#include <unistd.h>
 
 #include <functional>
 #include <memory>
@@ -34,9 +35,12 @@ void FuseOpsProxy::Init(void* /*userdata*/, struct fuse_conn_info* /*conn*/) {
   grpc::ClientContext client_context;
   GetInodeRequest req;
   req.set_path(fuse_options_.remote_mountpoint);
+  req.set_uid(getuid());
+  req.set_gid(getgid());
   GetInodeResponse resp;
   grpc::Status status = namenode_stub_->GetInode(&client_context, req, &resp);
   CHECK(status.ok());
+  Check(resp.error_code() == 0, resp.error_msg());
   mountpoint_inode_id_ = resp.id();
 }
 
@@ -17,6 +17,16 @@ struct FuseOptions {
   int entry_generation{0};
   double attr_timeout_sec{0.0};
   double entry_timeout_sec{0.0};
+  // A req shed by the namenode with `kThrottledError` is retried up to
+  // `throttled_max_retries` times, after a random backoff of up to
+  // `throttled_backoff_base_ms` doubled on every retry and capped at
+  // `throttled_backoff_max_ms`.
+  int throttled_max_retries{8};
+  int throttled_backoff_base_ms{10};
+  int throttled_backoff_max_ms{1000};
+  // The num of entries a `ListDir` fetches. Every entry comes with its `Stat`,
+  // so `readdirplus` costs one RPC per page rather than one per entry.
+  int list_dir_page_entries{1000};
 };
 
 }  // namespace rocketfs
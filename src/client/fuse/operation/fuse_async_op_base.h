@@ -5,12 +5,17 @@
 #define FUSE_USE_VERSION 312
 
 #include <fuse3/fuse_lowlevel.h>
+#include <grpcpp/alarm.h>
 #include <grpcpp/client_context.h>
 #include <grpcpp/impl/call.h>
 #include <grpcpp/support/status.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <random>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -35,6 +40,8 @@ class FuseAsyncOpBase {
 
   void Start(this auto&& self);
   void Finish(this auto&& self);
+  // Starts the RPC over after a backoff.
+  void Retry(this auto&& self);
 
  protected:
   FuseAsyncOpBase(const FuseOptions& fuse_options,
@@ -53,13 +60,18 @@ class FuseAsyncOpBase {
   Stub* stub_;
   grpc::CompletionQueue* cq_;
 
-  grpc::ClientContext cli_ctx_;
+  // Recreated by every `Start`, because a context cannot be reused.
+  std::unique_ptr<grpc::ClientContext> cli_ctx_;
   Rep req_;
   Resp resp_;
   grpc::Status status_;
   std::unique_ptr<grpc::ClientAsyncResponseReader<Resp>> resp_reader_;
 
   std::function<void()> on_finished_;
+
+  int throttled_retries_{0};
+  grpc::Alarm retry_alarm_;
+  std::function<void()> on_retry_;
 };
 
 template <typename Stub, typename Rep, typename Resp>
@@ -76,6 +88,11 @@ FuseAsyncOpBase<Stub, Rep, Resp>::FuseAsyncOpBase(
 
 template <typename Stub, typename Rep, typename Resp>
 void FuseAsyncOpBase<Stub, Rep, Resp>::Start(this auto&& self) {
+  self.cli_ctx_ = std::make_unique<grpc::ClientContext>();
+  // Sent along with the req, so the namenode drops it once we stop waiting.
+  self.cli_ctx_->set_deadline(
+      std::chrono::system_clock::now() +
+      std::chrono::milliseconds(self.fuse_options_.rpc_timeout_ms));
   self.PrepareAsyncRpcCall();
   self.resp_reader_->StartCall();
   self.on_finished_ = [&self]() { self.Finish(); };
@@ -89,18 +106,39 @@ void FuseAsyncOpBase<Stub, Rep, Resp>::Finish(this auto&& self) {
               "Failed to get a resp for req {}. Status: {}.",
               self.req_.ShortDebugString(),
               self.status_.error_message());
+    // Otherwise the kernel would wait for a reply forever.
+    self.LogReplyError(fuse_reply_err(
+        self.fuse_req_,
+        self.status_.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED
+            ? ETIMEDOUT
+            : EIO));
+    delete &self;
     return;
   }
 
   if constexpr (requires { self.resp_.error_code(); }) {
     static_assert(requires { self.resp_.error_msg(); });
+    if (static_cast<StatusCode>(self.resp_.error_code()) ==
+            StatusCode::kThrottledError &&
+        self.throttled_retries_ < self.fuse_options_.throttled_max_retries) {
+      LOG_DEBUG(logger,
+                "Req {} was throttled, retrying.",
+                self.req_.ShortDebugString());
+      self.Retry();
+      return;
+    }
     if (self.resp_.error_code() != 0) {
       LOG_DEBUG(logger,
                 "Received resp {} contains an error for req {}.",
                 self.resp_.ShortDebugString(),
                 self.req_.ShortDebugString());
+      auto status_code = static_cast<StatusCode>(self.resp_.error_code());
+      // Out of retries, here or on the namenode.
       std::optional<int> error_code =
-          self.ToErrno(static_cast<StatusCode>(self.resp_.error_code()));
+          status_code == StatusCode::kThrottledError ||
+                  status_code == StatusCode::kConflictError
+              ? EAGAIN
+              : self.ToErrno(status_code);
       if (!error_code) {
         LOG_ERROR(logger,
                   "Received resp {} contains an unknown error for req {}.",
@@ -109,6 +147,7 @@ void FuseAsyncOpBase<Stub, Rep, Resp>::Finish(this auto&& self) {
       }
       self.LogReplyError(
           fuse_reply_err(self.fuse_req_, error_code.value_or(EIO)));
+      delete &self;
       return;
     }
   }
@@ -122,6 +161,25 @@ void FuseAsyncOpBase<Stub, Rep, Resp>::Finish(this auto&& self) {
   delete &self;
 }
 
+template <typename Stub, typename Rep, typename Resp>
+void FuseAsyncOpBase<Stub, Rep, Resp>::Retry(this auto&& self) {
+  auto max_backoff_ms = std::min<int64_t>(
+      self.fuse_options_.throttled_backoff_max_ms,
+      static_cast<int64_t>(self.fuse_options_.throttled_backoff_base_ms)
+          << std::min(self.throttled_retries_, 20));
+  // A random backoff spreads out the retries of reqs throttled together.
+  thread_local std::mt19937_64 rng(std::random_device{}());
+  auto backoff_ms =
+      std::uniform_int_distribution<int64_t>(0, max_backoff_ms)(rng);
+  self.throttled_retries_++;
+  self.resp_.Clear();
+  self.on_retry_ = [&self]() { self.Start(); };
+  self.retry_alarm_.Set(
+      self.cq_,
+      std::chrono::system_clock::now() + std::chrono::milliseconds(backoff_ms),
+      &self.on_retry_);
+}
+
 template <typename Stub, typename Rep, typename Resp>
 struct fuse_entry_param FuseAsyncOpBase<Stub, Rep, Resp>::ToFuseEntryParam(
     uint64_t id, const Stat& stat) const {
@@ -19,16 +19,21 @@ FuseGetAttrOp::FuseGetAttrOp(const FuseOptions& fuse_options,
                              grpc::CompletionQueue* cq)
     : FuseAsyncOpBase(fuse_options, fuse_req, stub, cq) {
   req_.set_id(id);
+  auto ctx = CHECK_NOTNULL(fuse_req_ctx(fuse_req_));
+  req_.set_uid(ctx->uid);
+  req_.set_gid(ctx->gid);
 }
 
 void FuseGetAttrOp::PrepareAsyncRpcCall() {
-  resp_reader_ = stub_->PrepareAsyncGetInode(&cli_ctx_, req_, cq_);
+  resp_reader_ = stub_->PrepareAsyncGetInode(cli_ctx_.get(), req_, cq_);
 }
 
 std::optional<int> FuseGetAttrOp::ToErrno(StatusCode status_code) {
   switch (status_code) {
     case StatusCode::kNotFoundError:
       return ENOENT;
+    case StatusCode::kPermissionError:
+      return EACCES;
     default:
       return std::nullopt;
   }
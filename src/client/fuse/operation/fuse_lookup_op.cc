@@ -24,7 +24,7 @@ FuseLookupOp::FuseLookupOp(const FuseOptions& fuse_options,
 }
 
 void FuseLookupOp::PrepareAsyncRpcCall() {
-  resp_reader_ = stub_->PrepareAsyncLookup(&cli_ctx_, req_, cq_);
+  resp_reader_ = stub_->PrepareAsyncLookup(cli_ctx_.get(), req_, cq_);
 }
 
 std::optional<int> FuseLookupOp::ToErrno(StatusCode status_code) {
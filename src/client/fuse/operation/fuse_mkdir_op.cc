@@ -30,7 +30,7 @@ FuseMkdirOp::FuseMkdirOp(const FuseOptions& fuse_options,
 }
 
 void FuseMkdirOp::PrepareAsyncRpcCall() {
-  resp_reader_ = stub_->PrepareAsyncMkdirs(&cli_ctx_, req_, cq_);
+  resp_reader_ = stub_->PrepareAsyncMkdirs(cli_ctx_.get(), req_, cq_);
 }
 
 std::optional<int> FuseMkdirOp::ToErrno(StatusCode status_code) {
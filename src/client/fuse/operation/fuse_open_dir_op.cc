@@ -24,13 +24,17 @@ FuseOpenDirOp::FuseOpenDirOp(const FuseOptions& fuse_options,
     : FuseAsyncOpBase(fuse_options, fuse_req, stub, cq),
       file_info_(CHECK_NOTNULL(file_info)) {
   req_.set_id(id);
+  req_.set_limit(fuse_options_.list_dir_page_entries);
+  // Fetched along for `readdirplus`, which the kernel prefers if it is
+  // implemented.
+  req_.set_with_stat(true);
   auto ctx = CHECK_NOTNULL(fuse_req_ctx(fuse_req_));
   req_.set_uid(ctx->uid);
   req_.set_gid(ctx->gid);
 }
 
 void FuseOpenDirOp::PrepareAsyncRpcCall() {
-  resp_reader_ = stub_->PrepareAsyncListDir(&cli_ctx_, req_, cq_);
+  resp_reader_ = stub_->PrepareAsyncListDir(cli_ctx_.get(), req_, cq_);
 }
 
 std::optional<int> FuseOpenDirOp::ToErrno(StatusCode status_code) {
@@ -61,6 +65,7 @@ int FuseOpenDirOp::OnSuccess() {
                                     resp_.ents().begin(),
                                     resp_.ents().end());
   cache_dir_entries->has_more = resp_.has_more();
+  cache_dir_entries->cursor = resp_.next_cursor();
   file_info_->fh = reinterpret_cast<uint64_t>(cache_dir_entries);
   return fuse_reply_open(fuse_req_, file_info_);
 }
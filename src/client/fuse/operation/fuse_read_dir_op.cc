@@ -7,6 +7,7 @@
 #include <quill/core/ThreadContextManager.h>
 #include <sys/stat.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -20,16 +21,22 @@ FuseReadDirOp::FuseReadDirOp(const FuseOptions& fuse_options,
                              size_t size,
                              off_t off,
                              struct fuse_file_info* file_info,
+                             bool plus,
                              ClientNamenodeService::Stub* stub,
                              grpc::CompletionQueue* cq)
     : FuseAsyncOpBase(fuse_options, fuse_req, stub, cq),
       file_info_(CHECK_NOTNULL(file_info)),
+      plus_(plus),
       cache_dir_entries_(
           CHECK_NOTNULL(reinterpret_cast<CacheDirEntries*>(file_info->fh))),
       buf_holder_(size),
       buf_(buf_holder_) {
   static_assert(sizeof(off) == sizeof(cache_dir_entries_));
   CHECK_EQ(off, cache_dir_entries_->end_off);
+  req_.set_id(id);
+  req_.set_cursor(cache_dir_entries_->cursor);
+  req_.set_limit(fuse_options_.list_dir_page_entries);
+  req_.set_with_stat(plus_);
   auto ctx = CHECK_NOTNULL(fuse_req_ctx(fuse_req_));
   req_.set_uid(ctx->uid);
   req_.set_gid(ctx->gid);
@@ -49,7 +56,7 @@ void FuseReadDirOp::Start() {
 }
 
 void FuseReadDirOp::PrepareAsyncRpcCall() {
-  resp_reader_ = stub_->PrepareAsyncListDir(&cli_ctx_, req_, cq_);
+  resp_reader_ = stub_->PrepareAsyncListDir(cli_ctx_.get(), req_, cq_);
 }
 
 std::optional<int> FuseReadDirOp::ToErrno(StatusCode status_code) {
@@ -67,6 +74,7 @@ int FuseReadDirOp::OnSuccess() {
   CHECK(cache_dir_entries_->entries.empty());
   cache_dir_entries_->entries = {resp_.ents().begin(), resp_.ents().end()};
   cache_dir_entries_->has_more = resp_.has_more();
+  cache_dir_entries_->cursor = resp_.next_cursor();
   PopulateDirEntriesBuffer();
   return fuse_reply_buf(
       fuse_req_, buf_holder_.data(), buf_holder_.size() - buf_.size());
@@ -77,19 +85,38 @@ void FuseReadDirOp::PopulateDirEntriesBuffer() {
          cache_dir_entries_->entries.size()) {
     const auto& entry = cache_dir_entries_->entries.at(
         cache_dir_entries_->end_off - cache_dir_entries_->start_off);
-    // From the 'stbuf' argument the st_ino field and bits 12-15 (file type,
-    // e.g., regular file, directory) of the st_mode field are used. The other
-    // fields are ignored.
-    static_assert(S_IFMT == 0XF000);
-    struct stat stbuf;
-    stbuf.st_ino = entry.id();
-    stbuf.st_mode = entry.type();
-    auto bytes_written = fuse_add_direntry(fuse_req_,
-                                           buf_.data(),
-                                           buf_.size(),
-                                           entry.name().c_str(),
-                                           &stbuf,
-                                           cache_dir_entries_->end_off + 1);
+    size_t bytes_written = 0;
+    if (plus_) {
+      // The kernel skips "." and "..", and leaves an entry whose `ino` is 0,
+      // i.e., one without a `Stat`, to be looked up later.
+      struct fuse_entry_param fuse_entry{};
+      if (entry.has_stat()) {
+        fuse_entry = ToFuseEntryParam(entry.id(), entry.stat());
+      } else {
+        fuse_entry.attr.st_ino = entry.id();
+        fuse_entry.attr.st_mode = entry.type();
+      }
+      bytes_written = fuse_add_direntry_plus(fuse_req_,
+                                             buf_.data(),
+                                             buf_.size(),
+                                             entry.name().c_str(),
+                                             &fuse_entry,
+                                             cache_dir_entries_->end_off + 1);
+    } else {
+      // From the 'stbuf' argument the st_ino field and bits 12-15 (file type,
+      // e.g., regular file, directory) of the st_mode field are used. The
+      // other fields are ignored.
+      static_assert(S_IFMT == 0XF000);
+      struct stat stbuf;
+      stbuf.st_ino = entry.id();
+      stbuf.st_mode = entry.type();
+      bytes_written = fuse_add_direntry(fuse_req_,
+                                        buf_.data(),
+                                        buf_.size(),
+                                        entry.name().c_str(),
+                                        &stbuf,
+                                        cache_dir_entries_->end_off + 1);
+    }
     if (bytes_written > buf_.size()) {
       break;
     }
@@ -8,6 +8,7 @@
 
 #include <optional>
 #include <span>
+#include <string>
 #include <vector>
 
 #include "client/fuse/fuse_options.h"
@@ -25,8 +26,13 @@ struct CacheDirEntries {
   off_t end_off;
   std::vector<ListDirResponse::DEnt> entries;
   bool has_more;
+  // The opaque cursor of the next page, which resumes the listing at the
+  // snapshot the first page was read at.
+  std::string cursor;
 };
 
+// Serves both `readdir` and, if `plus` is set, `readdirplus`, which hands the
+// kernel the attrs of every entry along with it.
 class FuseReadDirOp : public FuseAsyncOpBase<ClientNamenodeService::Stub,
                                              ListDirRequest,
                                              ListDirResponse> {
@@ -37,6 +43,7 @@ class FuseReadDirOp : public FuseAsyncOpBase<ClientNamenodeService::Stub,
                 size_t size,
                 off_t off,
                 struct fuse_file_info* file_info,
+                bool plus,
                 ClientNamenodeService::Stub* stub,
                 grpc::CompletionQueue* cq);
 
@@ -49,6 +56,7 @@ class FuseReadDirOp : public FuseAsyncOpBase<ClientNamenodeService::Stub,
 
  private:
   struct fuse_file_info* file_info_;
+  bool plus_;
   CacheDirEntries* cache_dir_entries_;
   std::vector<char> buf_holder_;
   std::span<char> buf_;
@@ -0,0 +1,73 @@
+// Copyright 2025 RocketFS
+
+#include "common/clock_service.h"
+
+#include <gflags/gflags.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "common/logger.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(clock_tick_interval_us);
+
+ClockService::ClockService() : now_ns_(ReadCoarseNs()) {
+}
+
+ClockService::~ClockService() {
+  Stop();
+}
+
+void ClockService::Start() {
+  CHECK_NULL(thread_);
+  CHECK_GT(FLAGS_clock_tick_interval_us, 0);
+  stopped_ = false;
+  thread_ = std::make_unique<std::thread>([this]() {
+    while (true) {
+      Tick();
+      std::unique_lock lock(mutex_);
+      if (cv_.wait_for(
+              lock,
+              std::chrono::microseconds(FLAGS_clock_tick_interval_us),
+              [this]() { return stopped_; })) {
+        return;
+      }
+    }
+  });
+}
+
+void ClockService::Stop() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  thread_->join();
+  thread_ = nullptr;
+}
+
+int64_t ClockService::NowNs() const {
+  return now_ns_.load(std::memory_order_relaxed);
+}
+
+int64_t ClockService::ReadCoarseNs() {
+  timespec ts;
+  CHECK_EQ(clock_gettime(CLOCK_REALTIME_COARSE, &ts), 0);
+  return ts.tv_sec * kSecToNs + ts.tv_nsec;
+}
+
+void ClockService::Tick() {
+  // The ticker is the only writer, so a plain load and store suffice.
+  auto now_ns = std::max(ReadCoarseNs(), NowNs());
+  now_ns_.store(now_ns, std::memory_order_relaxed);
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,49 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "common/time_util.h"
+
+namespace rocketfs {
+
+// A `TimeUtilBase` whose `NowNs` is a single relaxed atomic load. One ticker
+// thread reads CLOCK_REALTIME_COARSE every `clock_tick_interval_us` and
+// publishes it, so timestamps are as fine as the tick interval, and never go
+// backwards even if the wall clock is stepped back: the cached time stands
+// still until the wall clock catches up.
+//
+// Before `Start`, or after `Stop`, `NowNs` returns the last published time.
+class ClockService : public TimeUtilBase {
+ public:
+  ClockService();
+  ClockService(const ClockService&) = delete;
+  ClockService(ClockService&&) = delete;
+  ClockService& operator=(const ClockService&) = delete;
+  ClockService& operator=(ClockService&&) = delete;
+  ~ClockService() override;
+
+  void Start();
+  void Stop();
+
+  int64_t NowNs() const override;
+
+ private:
+  static int64_t ReadCoarseNs();
+  void Tick();
+
+ private:
+  std::atomic<int64_t> now_ns_;
+  std::unique_ptr<std::thread> thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_{false};
+};
+
+}  // namespace rocketfs
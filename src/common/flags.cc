@@ -0,0 +1,12 @@
+// Copyright 2025 RocketFS
+
+#include <gflags/gflags.h>
+
+namespace rocketfs {
+
+DEFINE_uint32(clock_tick_interval_us,
+              1000,
+              "How often `ClockService` refreshes its cached time, which "
+              "bounds both the resolution and the staleness of timestamps.");
+
+}  // namespace rocketfs
@@ -25,6 +25,10 @@ enum class StatusCode : int16_t {
   kNotDirError = 6,
   kParentNotFoundError = 7,
   kParentNotDirError = 8,
+  // The req was shed under load before it ran. Retryable after a backoff.
+  kThrottledError = 9,
+  // The client stopped waiting for the resp, so the req was dropped.
+  kDeadlineExceededError = 10,
 
   // Error encountered in `KVStoreBase`.
   kConflictError = 1002,
@@ -70,6 +74,14 @@ class Status {
       std::string_view msg = "",
       const std::optional<Status>& internal_error = std::nullopt,
       std::source_location location = std::source_location::current());
+  inline static Status ThrottledError(
+      std::string_view msg = "",
+      const std::optional<Status>& internal_error = std::nullopt,
+      std::source_location location = std::source_location::current());
+  inline static Status DeadlineExceededError(
+      std::string_view msg = "",
+      const std::optional<Status>& internal_error = std::nullopt,
+      std::source_location location = std::source_location::current());
   inline static Status ConflictError(
       std::string_view msg = "",
       const std::optional<Status>& internal_error = std::nullopt,
@@ -81,6 +93,7 @@ class Status {
   Status& operator=(Status&&) = default;
   ~Status() = default;
 
+  inline StatusCode GetCode() const;
   inline std::string_view GetMsg() const;
 
   template <typename Resp>
@@ -141,6 +154,20 @@ Status Status::ParentNotDirError(std::string_view msg,
   return Status(StatusCode::kParentNotDirError, msg, internal_error, location);
 }
 
+Status Status::ThrottledError(std::string_view msg,
+                              const std::optional<Status>& internal_error,
+                              std::source_location location) {
+  return Status(StatusCode::kThrottledError, msg, internal_error, location);
+}
+
+Status Status::DeadlineExceededError(
+    std::string_view msg,
+    const std::optional<Status>& internal_error,
+    std::source_location location) {
+  return Status(
+      StatusCode::kDeadlineExceededError, msg, internal_error, location);
+}
+
 Status Status::ConflictError(std::string_view msg,
                              const std::optional<Status>& internal_error,
                              std::source_location location) {
@@ -177,6 +204,10 @@ Status::Status(StatusCode status_code,
   CHECK_EQ(msg_.back(), '.');
 }
 
+StatusCode Status::GetCode() const {
+  return status_code_;
+}
+
 std::string_view Status::GetMsg() const {
   return msg_;
 }
@@ -0,0 +1,95 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/common/arena_pool.h"
+
+#include <gflags/gflags.h>
+#include <prometheus/counter.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+#include "common/logger.h"
+#include "namenode/common/metrics.h"
+
+namespace rocketfs {
+
+DECLARE_uint64(arena_pool_max_free_bytes);
+
+namespace {
+
+constexpr size_t kSizeClassNum =
+    std::countr_zero(ArenaPool::kMaxBytes / ArenaPool::kMinBytes) + 1;
+
+size_t GetSizeClass(size_t bytes) {
+  return std::countr_zero(bytes / ArenaPool::kMinBytes);
+}
+
+struct FreeLists {
+  FreeLists() = default;
+  FreeLists(const FreeLists&) = delete;
+  FreeLists(FreeLists&&) = delete;
+  FreeLists& operator=(const FreeLists&) = delete;
+  FreeLists& operator=(FreeLists&&) = delete;
+  ~FreeLists() {
+    for (auto& bufs : size_classes) {
+      for (auto* buf : bufs) {
+        delete[] buf;
+      }
+    }
+  }
+
+  std::array<std::vector<std::byte*>, kSizeClassNum> size_classes;
+  size_t free_bytes{0};
+};
+
+thread_local FreeLists free_lists;
+
+// Only counted on the slow path, which calls malloc.
+prometheus::Counter& GetAllocCounter() {
+  static auto& counter = prometheus::BuildCounter()
+                             .Name("rocketfs_arena_pool_allocs_total")
+                             .Help("The num of arena buffers allocated "
+                                   "because none could be reused.")
+                             .Register(GetMetricsRegistry())
+                             .Add({});
+  return counter;
+}
+
+}  // namespace
+
+void ArenaPool::Releaser::operator()(std::byte* buf) const {
+  if (bytes > kMaxBytes ||
+      free_lists.free_bytes + bytes > FLAGS_arena_pool_max_free_bytes) {
+    delete[] buf;
+    return;
+  }
+  free_lists.size_classes[GetSizeClass(bytes)].push_back(buf);
+  free_lists.free_bytes += bytes;
+}
+
+size_t ArenaPool::RoundUp(size_t bytes) {
+  if (bytes > kMaxBytes) {
+    return bytes;
+  }
+  return std::max(std::bit_ceil(bytes), kMinBytes);
+}
+
+ArenaPool::Buffer ArenaPool::Acquire(size_t bytes) {
+  bytes = RoundUp(bytes);
+  if (bytes <= kMaxBytes) {
+    auto& bufs = free_lists.size_classes[GetSizeClass(bytes)];
+    if (!bufs.empty()) {
+      auto* buf = bufs.back();
+      bufs.pop_back();
+      free_lists.free_bytes -= bytes;
+      return Buffer(buf, Releaser{.bytes = bytes});
+    }
+  }
+  GetAllocCounter().Increment();
+  return Buffer(new std::byte[bytes], Releaser{.bytes = bytes});
+}
+
+}  // namespace rocketfs
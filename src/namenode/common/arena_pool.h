@@ -0,0 +1,37 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace rocketfs {
+
+// Recycles the buffers reqs carve their arenas from, so that in steady state a
+// req neither calls malloc nor faults in fresh pages. Buffers come in size
+// classes, the powers of two from `kMinBytes` to `kMaxBytes`. Every thread
+// keeps its own free lists and takes no lock. A buffer released on another
+// thread than the one that acquired it joins the free lists of the releasing
+// thread, so a thread that only releases hoards buffers the others then miss.
+// Ops are therefore built and destroyed on the op pool, where they run.
+class ArenaPool {
+ public:
+  static constexpr size_t kMinBytes = 1024;
+  static constexpr size_t kMaxBytes = 1024 * 1024;
+
+  struct Releaser {
+    size_t bytes;
+    void operator()(std::byte* buf) const;
+  };
+  using Buffer = std::unique_ptr<std::byte[], Releaser>;
+
+  ArenaPool() = delete;
+
+  // Rounds `bytes` up to its size class. Sizes above `kMaxBytes` are not
+  // pooled and are returned as is.
+  static size_t RoundUp(size_t bytes);
+  // Returns a buffer of `RoundUp(bytes)` bytes.
+  static Buffer Acquire(size_t bytes);
+};
+
+}  // namespace rocketfs
@@ -0,0 +1,57 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <expected>
+#include <limits>
+
+#include "common/logger.h"
+#include "common/status.h"
+#include "common/time_util.h"
+
+namespace rocketfs {
+
+// When a req stops being worth serving, i.e., when its client stops waiting
+// for the resp. Ops check it before every step and txns before every KV call,
+// so the work of an abandoned req stops at its next step instead of using up
+// capacity under overload.
+class Deadline {
+ public:
+  // Never expires.
+  Deadline() = default;
+  Deadline(TimeUtilBase* time_util, int64_t deadline_ns);
+  Deadline(const Deadline&) = default;
+  Deadline(Deadline&&) = default;
+  Deadline& operator=(const Deadline&) = default;
+  Deadline& operator=(Deadline&&) = default;
+  ~Deadline() = default;
+
+  bool IsExpired() const;
+  // Returns `DeadlineExceededError` once expired.
+  std::expected<void, Status> Check() const;
+
+ private:
+  TimeUtilBase* time_util_{nullptr};
+  int64_t deadline_ns_{std::numeric_limits<int64_t>::max()};
+};
+
+inline Deadline::Deadline(TimeUtilBase* time_util, int64_t deadline_ns)
+    : time_util_(CHECK_NOTNULL(time_util)), deadline_ns_(deadline_ns) {
+}
+
+inline bool Deadline::IsExpired() const {
+  return time_util_ != nullptr && time_util_->NowNs() >= deadline_ns_;
+}
+
+inline std::expected<void, Status> Deadline::Check() const {
+  if (IsExpired()) {
+    return std::unexpected(Status::DeadlineExceededError(
+        fmt::format("The deadline {} ns has passed.", deadline_ns_)));
+  }
+  return {};
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,105 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <fmt/core.h>
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <type_traits>
+
+#include "common/logger.h"
+#include "common/status.h"
+
+namespace rocketfs {
+
+template <typename T>
+concept IDGenCompatible =
+    std::is_standard_layout_v<T> && sizeof(T) == sizeof(uint64_t) &&
+    std::is_constructible_v<T, uint64_t>;
+
+// Grants ranges of IDs that are never granted again, not even after a restart.
+class IDLeaserBase {
+ public:
+  IDLeaserBase() = default;
+  IDLeaserBase(const IDLeaserBase&) = delete;
+  IDLeaserBase(IDLeaserBase&&) = delete;
+  IDLeaserBase& operator=(const IDLeaserBase&) = delete;
+  IDLeaserBase& operator=(IDLeaserBase&&) = delete;
+  virtual ~IDLeaserBase() = default;
+
+  // Returns the first ID of the granted range [first, first + count).
+  virtual std::expected<uint64_t, Status> Lease(uint64_t count) = 0;
+};
+
+// Hands out IDs from per-thread blocks leased from an `IDLeaserBase`, so
+// `Next` touches no shared state except when a thread's block runs out. IDs
+// left in a block when the process exits are skipped rather than reused.
+template <typename T>
+  requires IDGenCompatible<T>
+class LeasedIDGen {
+ public:
+  LeasedIDGen(IDLeaserBase* leaser, uint64_t block_size);
+  LeasedIDGen(const LeasedIDGen&) = delete;
+  LeasedIDGen(LeasedIDGen&&) = delete;
+  LeasedIDGen& operator=(const LeasedIDGen&) = delete;
+  LeasedIDGen& operator=(LeasedIDGen&&) = delete;
+  ~LeasedIDGen() = default;
+
+  std::expected<T, Status> Next();
+
+ private:
+  struct Block {
+    // Tells apart blocks of different generators, including generators
+    // constructed at the address of a destroyed one.
+    uint64_t gen_id{0};
+    uint64_t next{0};
+    uint64_t end{0};
+  };
+
+  static uint64_t NewGenID();
+
+  IDLeaserBase* leaser_;
+  const uint64_t block_size_;
+  const uint64_t gen_id_;
+  static thread_local Block block_;
+};
+
+template <typename T>
+  requires IDGenCompatible<T>
+thread_local typename LeasedIDGen<T>::Block LeasedIDGen<T>::block_;
+
+template <typename T>
+  requires IDGenCompatible<T>
+LeasedIDGen<T>::LeasedIDGen(IDLeaserBase* leaser, uint64_t block_size)
+    : leaser_(CHECK_NOTNULL(leaser)),
+      block_size_(block_size),
+      gen_id_(NewGenID()) {
+  CHECK_GT(block_size_, 0);
+}
+
+template <typename T>
+  requires IDGenCompatible<T>
+std::expected<T, Status> LeasedIDGen<T>::Next() {
+  if (block_.gen_id != gen_id_ || block_.next == block_.end) {
+    auto first = leaser_->Lease(block_size_);
+    if (!first) {
+      return std::unexpected(Status::SystemError(
+          fmt::format("Failed to lease a block of {} IDs.", block_size_),
+          first.error()));
+    }
+    block_ = Block{
+        .gen_id = gen_id_, .next = *first, .end = *first + block_size_};
+  }
+  return T(block_.next++);
+}
+
+template <typename T>
+  requires IDGenCompatible<T>
+uint64_t LeasedIDGen<T>::NewGenID() {
+  static std::atomic<uint64_t> next_gen_id{1};
+  return next_gen_id.fetch_add(1);
+}
+
+}  // namespace rocketfs
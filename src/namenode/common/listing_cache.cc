@@ -0,0 +1,173 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/common/listing_cache.h"
+
+#include <absl/hash/hash.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "common/logger.h"
+#include "namenode/common/metrics.h"
+
+namespace rocketfs {
+
+ListingCache::ListingCache(size_t capacity_bytes, uint32_t admit_listings)
+    : shard_capacity_bytes_(capacity_bytes / kShardNum),
+      admit_listings_(admit_listings) {
+  auto& registry = GetMetricsRegistry();
+  hits_ = &prometheus::BuildCounter()
+               .Name("rocketfs_listing_cache_hits_total")
+               .Help("The num of list dir pages served from the cache.")
+               .Register(registry)
+               .Add({});
+  misses_ = &prometheus::BuildCounter()
+                 .Name("rocketfs_listing_cache_misses_total")
+                 .Help("The num of list dir pages not found in the cache.")
+                 .Register(registry)
+                 .Add({});
+  bytes_ = &prometheus::BuildGauge()
+                .Name("rocketfs_listing_cache_bytes")
+                .Help("The bytes of list dir pages cached.")
+                .Register(registry)
+                .Add({});
+}
+
+uint64_t ListingCache::GetVersion(InodeID dir_id) {
+  auto& shard = GetShard(dir_id);
+  std::lock_guard lock(shard.mutex);
+  return shard.version;
+}
+
+void ListingCache::Invalidate(InodeID dir_id) {
+  if (shard_capacity_bytes_ == 0) {
+    return;
+  }
+  auto& shard = GetShard(dir_id);
+  std::lock_guard lock(shard.mutex);
+  shard.version++;
+  auto it = shard.dirs.find(dir_id.val);
+  if (it != shard.dirs.end()) {
+    EvictDir(&shard, it);
+  }
+}
+
+std::shared_ptr<const ListingCache::Page> ListingCache::Get(
+    InodeID dir_id, std::string_view key) {
+  if (shard_capacity_bytes_ == 0) {
+    return nullptr;
+  }
+  auto& shard = GetShard(dir_id);
+  {
+    std::lock_guard lock(shard.mutex);
+    shard.listings[dir_id.val]++;
+    if (++shard.listings_since_decay >= kDecayListings) {
+      shard.listings_since_decay = 0;
+      absl::erase_if(shard.listings, [](auto& listing) {
+        listing.second /= 2;
+        return listing.second == 0;
+      });
+    }
+    auto dir_it = shard.dirs.find(dir_id.val);
+    if (dir_it != shard.dirs.end()) {
+      auto page_it = dir_it->second.pages.find(key);
+      if (page_it != dir_it->second.pages.end()) {
+        hits_->Increment();
+        return page_it->second;
+      }
+    }
+  }
+  misses_->Increment();
+  return nullptr;
+}
+
+void ListingCache::Erase(InodeID dir_id, std::string_view key) {
+  auto& shard = GetShard(dir_id);
+  std::lock_guard lock(shard.mutex);
+  auto dir_it = shard.dirs.find(dir_id.val);
+  if (dir_it == shard.dirs.end()) {
+    return;
+  }
+  auto page_it = dir_it->second.pages.find(key);
+  if (page_it == dir_it->second.pages.end()) {
+    return;
+  }
+  auto bytes = GetBytes(key, *page_it->second);
+  dir_it->second.pages.erase(page_it);
+  CHECK_GE(dir_it->second.bytes, bytes);
+  dir_it->second.bytes -= bytes;
+  shard.bytes -= bytes;
+  bytes_->Decrement(static_cast<double>(bytes));
+  if (dir_it->second.pages.empty()) {
+    shard.dirs.erase(dir_it);
+  }
+}
+
+bool ListingCache::Admits(InodeID dir_id) {
+  if (shard_capacity_bytes_ == 0) {
+    return false;
+  }
+  auto& shard = GetShard(dir_id);
+  std::lock_guard lock(shard.mutex);
+  auto it = shard.listings.find(dir_id.val);
+  return it != shard.listings.end() && it->second >= admit_listings_;
+}
+
+void ListingCache::Put(InodeID dir_id,
+                       uint64_t version,
+                       std::string_view key,
+                       Page page) {
+  auto bytes = GetBytes(key, page);
+  if (bytes > shard_capacity_bytes_) {
+    return;
+  }
+  auto& shard = GetShard(dir_id);
+  std::lock_guard lock(shard.mutex);
+  if (version != shard.version) {
+    return;
+  }
+  if (auto it = shard.listings.find(dir_id.val);
+      it == shard.listings.end() || it->second < admit_listings_) {
+    return;
+  }
+  auto& dir = shard.dirs[dir_id.val];
+  auto [page_it, inserted] = dir.pages.try_emplace(std::string(key));
+  if (!inserted) {
+    // Filled by a concurrent listing of the same page.
+    return;
+  }
+  page_it->second = std::make_shared<const Page>(std::move(page));
+  dir.bytes += bytes;
+  shard.bytes += bytes;
+  bytes_->Increment(static_cast<double>(bytes));
+  while (shard.bytes > shard_capacity_bytes_) {
+    // The iteration order of `absl::flat_hash_map` is effectively random, so
+    // this evicts an arbitrary dir, possibly the one just filled.
+    EvictDir(&shard, shard.dirs.begin());
+  }
+}
+
+size_t ListingCache::GetBytes(std::string_view key, const Page& page) {
+  return key.size() + CHECK_NOTNULL(page.resp)->ByteSizeLong();
+}
+
+ListingCache::Shard& ListingCache::GetShard(InodeID dir_id) {
+  return shards_[absl::Hash<uint64_t>{}(dir_id.val) % kShardNum];
+}
+
+void ListingCache::EvictDir(
+    Shard* shard, absl::flat_hash_map<uint64_t, DirPages>::iterator it) {
+  CHECK_GE(shard->bytes, it->second.bytes);
+  shard->bytes -= it->second.bytes;
+  bytes_->Decrement(static_cast<double>(it->second.bytes));
+  shard->dirs.erase(it);
+}
+
+}  // namespace rocketfs
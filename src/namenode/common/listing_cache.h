@@ -0,0 +1,109 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+#include "src/proto/client_namenode.pb.h"
+
+namespace rocketfs {
+
+// Caches the `ListDirResponse` pages of hot dirs, e.g., dataset roots
+// or /tmp, keyed by the dir and the position and shape of the page, so that
+// repeat listings skip the txn, the range scan and the decoding of entries.
+// Pages are kept parsed, so a hit only copies one.
+//
+// Only dirs listed at least `listing_cache_admit_listings` times recently are
+// admitted, so one-off listings of cold dirs never evict hot ones. The counts
+// are halved every few thousand listings of a shard.
+//
+// Ops that change the entries of a dir, its ACL, or the cached stats of its
+// children call `Invalidate` on it once committed. A listing must take the
+// version of the dir before it starts its txn and pass it to `Put`, which
+// drops the page if the dir has been invalidated in between.
+class ListingCache {
+ public:
+  struct Page {
+    // The ACL of the dir when the page was read, which a hit checks the user
+    // of its req against.
+    Acl acl;
+    std::shared_ptr<const ListDirResponse> resp;
+    // The snapshot the `next_cursor` of `resp` reads the next page at, if
+    // any. A hit must keep it retained, or drop the page once it is not.
+    std::optional<int64_t> read_version;
+  };
+
+  // Holds pages of up to `capacity_bytes` in total. 0 disables the cache.
+  ListingCache(size_t capacity_bytes, uint32_t admit_listings);
+  ListingCache(const ListingCache&) = delete;
+  ListingCache(ListingCache&&) = delete;
+  ListingCache& operator=(const ListingCache&) = delete;
+  ListingCache& operator=(ListingCache&&) = delete;
+  ~ListingCache() = default;
+
+  uint64_t GetVersion(InodeID dir_id);
+  void Invalidate(InodeID dir_id);
+
+  // Returns nullptr on a miss. Hits and misses alike count as listings of the
+  // dir towards its admission, so that a hot dir served from the cache stays
+  // hot.
+  std::shared_ptr<const Page> Get(InodeID dir_id, std::string_view key);
+  // Drops a page that is no longer valid, e.g., whose snapshot has expired.
+  void Erase(InodeID dir_id, std::string_view key);
+  // Whether the dir is hot enough for its pages to be cached, which lets a
+  // listing skip encoding pages `Put` would ignore.
+  bool Admits(InodeID dir_id);
+  // Ignored if the dir is not hot enough, or has been invalidated since
+  // `version`.
+  void Put(InodeID dir_id, uint64_t version, std::string_view key, Page page);
+
+ private:
+  static constexpr size_t kShardNum = 64;
+  // Every this many listings of a shard, its listing counts are halved.
+  static constexpr uint32_t kDecayListings = 4096;
+
+  struct DirPages {
+    absl::flat_hash_map<std::string, std::shared_ptr<const Page>> pages;
+    size_t bytes = 0;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    // Bumped by every `Invalidate` of a dir in the shard, which keeps no
+    // version per dir at the cost of dropping a few pages of other dirs.
+    uint64_t version = 0;
+    absl::flat_hash_map<uint64_t, DirPages> dirs;
+    size_t bytes = 0;
+    absl::flat_hash_map<uint64_t, uint32_t> listings;
+    uint32_t listings_since_decay = 0;
+  };
+
+  // The bytes a page is accounted for, which its encoded size approximates.
+  static size_t GetBytes(std::string_view key, const Page& page);
+  Shard& GetShard(InodeID dir_id);
+  void EvictDir(Shard* shard,
+                absl::flat_hash_map<uint64_t, DirPages>::iterator it);
+
+ private:
+  size_t shard_capacity_bytes_;
+  uint32_t admit_listings_;
+  std::array<Shard, kShardNum> shards_;
+  prometheus::Counter* hits_;
+  prometheus::Counter* misses_;
+  prometheus::Gauge* bytes_;
+};
+
+}  // namespace rocketfs
@@ -0,0 +1,45 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/common/metrics.h"
+
+#include <gflags/gflags.h>
+#include <prometheus/exposer.h>
+#include <prometheus/registry.h>
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+
+#include <memory>
+
+#include "common/logger.h"
+
+namespace rocketfs {
+
+DECLARE_string(namenode_metrics_address);
+
+namespace {
+
+const std::shared_ptr<prometheus::Registry>& GetSharedMetricsRegistry() {
+  static auto registry = std::make_shared<prometheus::Registry>();
+  return registry;
+}
+
+}  // namespace
+
+prometheus::Registry& GetMetricsRegistry() {
+  return *GetSharedMetricsRegistry();
+}
+
+std::unique_ptr<prometheus::Exposer> StartMetricsExposer() {
+  if (FLAGS_namenode_metrics_address.empty()) {
+    return nullptr;
+  }
+  auto exposer =
+      std::make_unique<prometheus::Exposer>(FLAGS_namenode_metrics_address);
+  exposer->RegisterCollectable(GetSharedMetricsRegistry());
+  LOG_INFO(logger,
+           "Serving metrics at {}/metrics.",
+           FLAGS_namenode_metrics_address);
+  return exposer;
+}
+
+}  // namespace rocketfs
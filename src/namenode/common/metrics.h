@@ -0,0 +1,20 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <prometheus/exposer.h>
+#include <prometheus/registry.h>
+
+#include <memory>
+
+namespace rocketfs {
+
+// The registry every namenode metric is added to.
+prometheus::Registry& GetMetricsRegistry();
+
+// Serves `GetMetricsRegistry` over HTTP at `namenode_metrics_address`, or
+// returns nullptr if it is empty. Metrics are served until the returned
+// exposer is destroyed.
+std::unique_ptr<prometheus::Exposer> StartMetricsExposer();
+
+}  // namespace rocketfs
@@ -0,0 +1,92 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/common/path_prefix_cache.h"
+
+#include <absl/hash/hash.h>
+#include <prometheus/counter.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "namenode/common/metrics.h"
+
+namespace rocketfs {
+
+PathPrefixCache::PathPrefixCache(size_t capacity)
+    : shard_capacity_((capacity + kShardNum - 1) / kShardNum) {
+  auto& registry = GetMetricsRegistry();
+  hits_ = &prometheus::BuildCounter()
+               .Name("rocketfs_path_prefix_cache_hits_total")
+               .Help("The num of path walks that started from a cached "
+                     "prefix.")
+               .Register(registry)
+               .Add({});
+  misses_ = &prometheus::BuildCounter()
+                 .Name("rocketfs_path_prefix_cache_misses_total")
+                 .Help("The num of path prefixes probed but not cached.")
+                 .Register(registry)
+                 .Add({});
+}
+
+uint64_t PathPrefixCache::GetVersion() const {
+  return version_.load(std::memory_order_acquire);
+}
+
+void PathPrefixCache::Invalidate() {
+  version_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::optional<PathPrefixCache::Entry> PathPrefixCache::Get(
+    std::string_view prefix) {
+  if (shard_capacity_ == 0) {
+    return std::nullopt;
+  }
+  auto version = GetVersion();
+  auto& shard = GetShard(prefix);
+  {
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.entries.find(prefix);
+    if (it != shard.entries.end()) {
+      if (it->second.version == version) {
+        hits_->Increment();
+        return it->second.entry;
+      }
+      shard.entries.erase(it);
+    }
+  }
+  misses_->Increment();
+  return std::nullopt;
+}
+
+void PathPrefixCache::Put(std::string_view prefix,
+                          uint64_t version,
+                          const Entry& entry) {
+  if (shard_capacity_ == 0 || version != GetVersion()) {
+    return;
+  }
+  auto& shard = GetShard(prefix);
+  std::lock_guard lock(shard.mutex);
+  auto it = shard.entries.find(prefix);
+  if (it != shard.entries.end()) {
+    it->second = VersionedEntry{.version = version, .entry = entry};
+    return;
+  }
+  if (shard.entries.size() >= shard_capacity_) {
+    // The iteration order of `absl::flat_hash_map` is effectively random, so
+    // this evicts an arbitrary entry without tracking recency.
+    shard.entries.erase(shard.entries.begin());
+  }
+  shard.entries.emplace(std::string(prefix),
+                        VersionedEntry{.version = version, .entry = entry});
+}
+
+PathPrefixCache::Shard& PathPrefixCache::GetShard(std::string_view prefix) {
+  return shards_[absl::Hash<std::string_view>{}(prefix) % kShardNum];
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,85 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+#include <prometheus/counter.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+// Caches the dirs that path prefixes resolve to, e.g., "/a/b" to the ID of b
+// and the ACLs of /, a and b, so that a path walk starts from the longest
+// cached prefix instead of the root. The ACLs are kept rather than a verdict,
+// since the search perm is checked against the user of every req.
+//
+// Entries are tagged with the version of the namespace they were read at.
+// Ops that remove, rename or chmod dirs call `Invalidate` once committed,
+// which drops every entry at once. Creates never replace an entry, since
+// `MkdirsOp` and `BulkCreateOp` read the name first and fail with
+// `AlreadyExistsError`, and missing prefixes are never cached, so creates
+// change no cached prefix and need nothing.
+//
+// A walk must take the version before it starts its txn, so that what it
+// reads is never older than the version it tags its entries with.
+class PathPrefixCache {
+ public:
+  struct Entry {
+    InodeID id;
+    // From the root to `id`.
+    std::vector<Acl> acls;
+  };
+
+  // Holds up to `capacity` prefixes. 0 disables the cache.
+  explicit PathPrefixCache(size_t capacity);
+  PathPrefixCache(const PathPrefixCache&) = delete;
+  PathPrefixCache(PathPrefixCache&&) = delete;
+  PathPrefixCache& operator=(const PathPrefixCache&) = delete;
+  PathPrefixCache& operator=(PathPrefixCache&&) = delete;
+  ~PathPrefixCache() = default;
+
+  uint64_t GetVersion() const;
+  void Invalidate();
+
+  // `prefix` is absolute, with neither empty components nor a trailing '/'
+  // other than the root's.
+  std::optional<Entry> Get(std::string_view prefix);
+  // Ignored if the namespace has been invalidated since `version`.
+  void Put(std::string_view prefix, uint64_t version, const Entry& entry);
+
+ private:
+  static constexpr size_t kShardNum = 16;
+
+  struct VersionedEntry {
+    uint64_t version;
+    Entry entry;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    absl::flat_hash_map<std::string, VersionedEntry> entries;
+  };
+
+  Shard& GetShard(std::string_view prefix);
+
+ private:
+  size_t shard_capacity_;
+  std::atomic<uint64_t> version_{0};
+  std::array<Shard, kShardNum> shards_;
+  prometheus::Counter* hits_;
+  prometheus::Counter* misses_;
+};
+
+}  // namespace rocketfs
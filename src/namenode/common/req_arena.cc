@@ -0,0 +1,119 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/common/req_arena.h"
+
+#include <gflags/gflags.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+#include "common/logger.h"
+#include "namenode/common/arena_pool.h"
+#include "namenode/common/metrics.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(request_monotonic_buffer_resource_prealloc_bytes);
+DECLARE_uint32(arena_sizer_window_reqs);
+
+ArenaSizer::ArenaSizer(std::string_view rpc_name)
+    : bytes_(ArenaPool::RoundUp(
+          FLAGS_request_monotonic_buffer_resource_prealloc_bytes)) {
+  auto& registry = GetMetricsRegistry();
+  bytes_gauge_ = &prometheus::BuildGauge()
+                      .Name("rocketfs_req_arena_bytes")
+                      .Help("The size of the arena a req starts with.")
+                      .Register(registry)
+                      .Add({{"rpc", std::string(rpc_name)}});
+  overflows_ = &prometheus::BuildCounter()
+                    .Name("rocketfs_req_arena_overflows_total")
+                    .Help("The num of reqs that outgrew their first arena "
+                          "buffer.")
+                    .Register(registry)
+                    .Add({{"rpc", std::string(rpc_name)}});
+  bytes_gauge_->Set(bytes_);
+}
+
+size_t ArenaSizer::GetBytes() const {
+  return bytes_.load(std::memory_order_relaxed);
+}
+
+void ArenaSizer::Report(size_t used_bytes, bool overflowed) {
+  if (overflowed) {
+    overflows_->Increment();
+  }
+  auto max_bytes = window_max_bytes_.load(std::memory_order_relaxed);
+  while (used_bytes > max_bytes &&
+         !window_max_bytes_.compare_exchange_weak(
+             max_bytes, used_bytes, std::memory_order_relaxed)) {
+  }
+  if (window_reqs_.fetch_add(1, std::memory_order_relaxed) + 1 <
+      FLAGS_arena_sizer_window_reqs) {
+    return;
+  }
+  // Reqs finishing meanwhile may be counted in either window, which does not
+  // matter for sizing.
+  window_reqs_.store(0, std::memory_order_relaxed);
+  auto bytes = ArenaPool::RoundUp(std::clamp(
+      window_max_bytes_.exchange(0, std::memory_order_relaxed),
+      ArenaPool::kMinBytes,
+      ArenaPool::kMaxBytes));
+  bytes_.store(bytes, std::memory_order_relaxed);
+  bytes_gauge_->Set(bytes);
+}
+
+ReqArena::ReqArena(ArenaSizer* sizer) : sizer_(CHECK_NOTNULL(sizer)) {
+}
+
+ReqArena::~ReqArena() {
+  // Reqs that allocate nothing would only drag the size down.
+  if (buffers_.empty()) {
+    return;
+  }
+  auto used_bytes =
+      used_bytes_before_ + (buffers_.back().get_deleter().bytes - left_bytes_);
+  sizer_->Report(used_bytes, buffers_.size() > 1);
+}
+
+void* ReqArena::do_allocate(size_t bytes, size_t alignment) {
+  void* p = next_;
+  if (std::align(alignment, bytes, p, left_bytes_) == nullptr) {
+    Grow(bytes + alignment);
+    p = next_;
+    CHECK_NOTNULL(std::align(alignment, bytes, p, left_bytes_));
+  }
+  next_ = static_cast<std::byte*>(p) + bytes;
+  left_bytes_ -= bytes;
+  return p;
+}
+
+void ReqArena::do_deallocate(void* /*p*/,
+                             size_t /*bytes*/,
+                             size_t /*alignment*/) {
+}
+
+bool ReqArena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+void ReqArena::Grow(size_t min_bytes) {
+  size_t bytes = std::max(min_bytes, sizer_->GetBytes());
+  if (!buffers_.empty()) {
+    auto last_bytes = buffers_.back().get_deleter().bytes;
+    used_bytes_before_ += last_bytes - left_bytes_;
+    bytes = std::max(bytes, last_bytes * 2);
+  }
+  buffers_.emplace_back(ArenaPool::Acquire(bytes));
+  next_ = buffers_.back().get();
+  left_bytes_ = buffers_.back().get_deleter().bytes;
+}
+
+}  // namespace rocketfs
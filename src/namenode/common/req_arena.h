@@ -0,0 +1,73 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <absl/container/inlined_vector.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+
+#include "namenode/common/arena_pool.h"
+
+namespace rocketfs {
+
+// Learns how large the arenas of one RPC type should be from the high-water
+// marks of its recent reqs, so that e.g. large ListDir pages get large arenas
+// while GetInode keeps small ones.
+class ArenaSizer {
+ public:
+  explicit ArenaSizer(std::string_view rpc_name);
+  ArenaSizer(const ArenaSizer&) = delete;
+  ArenaSizer(ArenaSizer&&) = delete;
+  ArenaSizer& operator=(const ArenaSizer&) = delete;
+  ArenaSizer& operator=(ArenaSizer&&) = delete;
+  ~ArenaSizer() = default;
+
+  size_t GetBytes() const;
+  void Report(size_t used_bytes, bool overflowed);
+
+ private:
+  std::atomic<size_t> bytes_;
+  std::atomic<size_t> window_max_bytes_{0};
+  std::atomic<uint32_t> window_reqs_{0};
+  prometheus::Gauge* bytes_gauge_;
+  prometheus::Counter* overflows_;
+};
+
+// The memory resource of a req: a bump allocator over a buffer of the size its
+// `ArenaSizer` suggests, taken on the first allocation. When the buffer runs
+// out it chains a larger one, also from `ArenaPool`. Nothing is freed before
+// the arena is destroyed, which returns the buffers to the pool and reports the
+// bytes used.
+class ReqArena : public std::pmr::memory_resource {
+ public:
+  explicit ReqArena(ArenaSizer* sizer);
+  ReqArena(const ReqArena&) = delete;
+  ReqArena(ReqArena&&) = delete;
+  ReqArena& operator=(const ReqArena&) = delete;
+  ReqArena& operator=(ReqArena&&) = delete;
+  ~ReqArena() override;
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  void Grow(size_t min_bytes);
+
+ private:
+  ArenaSizer* sizer_;
+  absl::InlinedVector<ArenaPool::Buffer, 4> buffers_;
+  std::byte* next_{nullptr};
+  size_t left_bytes_{0};
+  // The bytes used of the buffers before the current one.
+  size_t used_bytes_before_{0};
+};
+
+}  // namespace rocketfs
@@ -0,0 +1,37 @@
+// Copyright 2025 RocketFS
+
+#include <gflags/gflags.h>
+
+namespace rocketfs {
+
+DEFINE_uint64(inode_id_block_size,
+              4096,
+              "The num of inode IDs a thread leases at a time. Every lease "
+              "persists a new high-water mark, and IDs left unused in a block "
+              "at exit are skipped.");
+DEFINE_uint64(arena_pool_max_free_bytes,
+              64 * 1024 * 1024,
+              "The max bytes of req arena buffers each thread keeps for "
+              "reuse.");
+DEFINE_uint32(arena_sizer_window_reqs,
+              1024,
+              "Every this many reqs of an RPC type, its arena size is set to "
+              "the largest arena any of them used.");
+DEFINE_uint64(path_prefix_cache_capacity,
+              1'000'000,
+              "The max num of resolved path prefixes cached for path walks. "
+              "0 disables the cache.");
+DEFINE_uint64(listing_cache_capacity_bytes,
+              256 * 1024 * 1024,
+              "The max bytes of list dir pages cached for hot dirs. 0 "
+              "disables the cache.");
+DEFINE_uint32(listing_cache_admit_listings,
+              8,
+              "The num of recent listings of a dir after which its pages are "
+              "cached.");
+DEFINE_string(namenode_metrics_address,
+              "",
+              "The host:port Prometheus metrics are served at, e.g., "
+              "0.0.0.0:9464. Empty disables serving them.");
+
+}  // namespace rocketfs
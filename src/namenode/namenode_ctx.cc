@@ -2,31 +2,49 @@
 
 #include "namenode/namenode_ctx.h"
 
+#include <gflags/gflags.h>
+
 #include <memory>
 
+#include "common/clock_service.h"
 #include "common/time_util.h"
+#include "namenode/common/listing_cache.h"
+#include "namenode/common/path_prefix_cache.h"
+#include "namenode/table/kv/column_family.h"
 #include "namenode/table/kv/rocksdb_kv_store.h"
 
 namespace rocketfs {
 
+DECLARE_uint64(inode_id_block_size);
+DECLARE_uint64(path_prefix_cache_capacity);
+DECLARE_uint64(listing_cache_capacity_bytes);
+DECLARE_uint32(listing_cache_admit_listings);
+
 NameNodeCtx::NameNodeCtx()
     : kv_store_(std::make_unique<RocksDBKVStore>()),
-      time_util_(std::make_unique<TimeUtil>()),
-      id_generator_manager_(time_util_.get()) {
+      kv_scrubber_(kv_store_.get()),
+      inode_id_leaser_(kv_store_.get(),
+                       kInodeIDHWMKey,
+                       kInodeCFIndex,
+                       kRootInodeID.val + 1),
+      inode_id_generator_(&inode_id_leaser_, FLAGS_inode_id_block_size),
+      path_prefix_cache_(FLAGS_path_prefix_cache_capacity),
+      listing_cache_(FLAGS_listing_cache_capacity_bytes,
+                     FLAGS_listing_cache_admit_listings) {
 }
 
 void NameNodeCtx::Start() {
-  inode_id_generator_ = std::make_unique<InodeIDGen>(0, 0, 0);
-  id_generator_manager_.AddIDGenerator(inode_id_generator_.get());
-  id_generator_manager_.Start();
+  clock_.Start();
+  kv_scrubber_.Start();
 }
 
 void NameNodeCtx::Stop() {
-  id_generator_manager_.Stop();
+  kv_scrubber_.Stop();
+  clock_.Stop();
 }
 
 TimeUtilBase* NameNodeCtx::GetTimeUtil() {
-  return time_util_.get();
+  return &clock_;
 }
 
 KVStoreBase* NameNodeCtx::GetKVStore() {
@@ -34,7 +52,15 @@ KVStoreBase* NameNodeCtx::GetKVStore() {
 }
 
 InodeIDGen& NameNodeCtx::GetInodeIDGen() {
-  return *inode_id_generator_;
+  return inode_id_generator_;
+}
+
+PathPrefixCache& NameNodeCtx::GetPathPrefixCache() {
+  return path_prefix_cache_;
+}
+
+ListingCache& NameNodeCtx::GetListingCache() {
+  return listing_cache_;
 }
 
 }  // namespace rocketfs
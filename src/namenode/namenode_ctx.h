@@ -2,9 +2,13 @@
 
 #include <memory>
 
+#include "common/clock_service.h"
 #include "common/time_util.h"
-#include "namenode/common/id_gen.h"
+#include "namenode/common/listing_cache.h"
+#include "namenode/common/path_prefix_cache.h"
 #include "namenode/table/inode_id.h"
+#include "namenode/table/kv/kv_id_leaser.h"
+#include "namenode/table/kv/kv_scrubber.h"
 #include "namenode/table/kv/kv_store_base.h"
 
 namespace rocketfs {
@@ -24,12 +28,17 @@ class NameNodeCtx {
   KVStoreBase* GetKVStore();
   TimeUtilBase* GetTimeUtil();
   InodeIDGen& GetInodeIDGen();
+  PathPrefixCache& GetPathPrefixCache();
+  ListingCache& GetListingCache();
 
  private:
-  std::unique_ptr<TimeUtilBase> time_util_;
+  ClockService clock_;
   std::unique_ptr<KVStoreBase> kv_store_;
-  IDGenMgr id_generator_manager_;
-  std::unique_ptr<InodeIDGen> inode_id_generator_;
+  KVScrubber kv_scrubber_;
+  KVIDLeaser inode_id_leaser_;
+  InodeIDGen inode_id_generator_;
+  PathPrefixCache path_prefix_cache_;
+  ListingCache listing_cache_;
 };
 
 }  // namespace rocketfs
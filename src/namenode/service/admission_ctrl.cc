@@ -0,0 +1,214 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/service/admission_ctrl.h"
+
+#include <fmt/core.h>
+#include <gflags/gflags.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <unifex/coroutine.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/task.hpp>
+
+#include "common/logger.h"
+#include "common/status.h"
+#include "common/time_util.h"
+#include "namenode/common/metrics.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(admission_tenant_qps);
+DECLARE_uint32(admission_tenant_burst);
+DECLARE_uint32(admission_max_tenants);
+DECLARE_uint32(admission_max_inflight_ops);
+DECLARE_uint32(admission_max_queued_ops);
+DECLARE_uint32(admission_read_weight);
+DECLARE_uint32(admission_mutation_weight);
+DECLARE_uint32(admission_listing_weight);
+
+namespace {
+
+constexpr std::string_view kOpClassNames[kOpClassNum] = {
+    "read", "mutation", "listing"};
+
+}  // namespace
+
+AdmissionCtrl::Permit::Permit(AdmissionCtrl* admission_ctrl)
+    : admission_ctrl_(CHECK_NOTNULL(admission_ctrl)) {
+}
+
+AdmissionCtrl::Permit::Permit(Permit&& other)
+    : admission_ctrl_(other.admission_ctrl_) {
+  other.admission_ctrl_ = nullptr;
+}
+
+AdmissionCtrl::Permit::~Permit() {
+  if (admission_ctrl_ != nullptr) {
+    admission_ctrl_->Release();
+  }
+}
+
+AdmissionCtrl::AdmissionCtrl(TimeUtilBase* time_util)
+    : time_util_(CHECK_NOTNULL(time_util)) {
+  auto& registry = GetMetricsRegistry();
+  auto& queue_depth = prometheus::BuildGauge()
+                          .Name("rocketfs_admission_queue_depth")
+                          .Help("The num of ops waiting to be admitted.")
+                          .Register(registry);
+  auto& admitted = prometheus::BuildCounter()
+                       .Name("rocketfs_admission_admitted_total")
+                       .Help("The num of ops admitted.")
+                       .Register(registry);
+  auto& shed = prometheus::BuildCounter()
+                   .Name("rocketfs_admission_shed_total")
+                   .Help("The num of ops shed with ThrottledError.")
+                   .Register(registry);
+  inflight_gauge_ = &prometheus::BuildGauge()
+                         .Name("rocketfs_admission_inflight_ops")
+                         .Help("The num of admitted ops still running.")
+                         .Register(registry)
+                         .Add({});
+
+  std::array<uint32_t, kOpClassNum> weights = {
+      FLAGS_admission_read_weight,
+      FLAGS_admission_mutation_weight,
+      FLAGS_admission_listing_weight};
+  for (size_t i = 0; i < kOpClassNum; i++) {
+    CHECK_GT(weights[i], 0);
+    auto op_class = std::string(kOpClassNames[i]);
+    auto& state = classes_[i];
+    state.weight = weights[i];
+    state.queue_depth = &queue_depth.Add({{"op_class", op_class}});
+    state.admitted = &admitted.Add({{"op_class", op_class}});
+    state.rate_limited =
+        &shed.Add({{"op_class", op_class}, {"reason", "rate_limited"}});
+    state.queue_full =
+        &shed.Add({{"op_class", op_class}, {"reason", "queue_full"}});
+  }
+}
+
+unifex::task<std::expected<AdmissionCtrl::Permit, Status>>
+AdmissionCtrl::Admit(OpClass op_class,
+                     std::string_view tenant,
+                     agrpc::GrpcContext* grpc_ctx) {
+  CHECK_NOTNULL(grpc_ctx);
+  auto& state = classes_[static_cast<size_t>(op_class)];
+  Waiter waiter;
+  {
+    std::lock_guard lock(mutex_);
+    auto runs_now = FLAGS_admission_max_inflight_ops == 0 ||
+                    inflight_ < FLAGS_admission_max_inflight_ops;
+    // Checked before the token is taken, so that an op shed for a full queue
+    // does not count against the rate of its tenant.
+    if (!runs_now && state.waiters.size() >= FLAGS_admission_max_queued_ops) {
+      state.queue_full->Increment();
+      co_return std::unexpected(Status::ThrottledError(fmt::format(
+          "Too many {} ops are queued.",
+          kOpClassNames[static_cast<size_t>(op_class)])));
+    }
+    if (!TakeToken(tenant)) {
+      state.rate_limited->Increment();
+      co_return std::unexpected(Status::ThrottledError(
+          fmt::format("Tenant {} is over its rate.", tenant)));
+    }
+    if (runs_now) {
+      inflight_++;
+      inflight_gauge_->Set(inflight_);
+      state.admitted->Increment();
+      co_return Permit(this);
+    }
+    if (state.waiters.empty()) {
+      // A class does not bank credit while it has nothing queued.
+      state.last_finish_vtime = std::max(state.last_finish_vtime, vtime_);
+    }
+    state.waiters.push_back(&waiter);
+    state.queue_depth->Increment();
+  }
+  // `Release` hands its inflight slot over before setting the event, on the
+  // thread of the op releasing it, so the op hops back to its own context
+  // rather than run on, and hold up, the other's.
+  co_await waiter.admitted.async_wait();
+  co_await unifex::schedule(grpc_ctx->get_scheduler());
+  co_return Permit(this);
+}
+
+bool AdmissionCtrl::TakeToken(std::string_view tenant) {
+  if (FLAGS_admission_tenant_qps == 0) {
+    return true;
+  }
+  auto now_ns = time_util_->NowNs();
+  auto burst = static_cast<double>(std::max(FLAGS_admission_tenant_burst, 1U));
+  auto refill = [&](TokenBucket* bucket) {
+    auto elapsed_ns = std::max<int64_t>(now_ns - bucket->refilled_at_ns, 0);
+    bucket->tokens =
+        std::min(burst,
+                 bucket->tokens + static_cast<double>(elapsed_ns) *
+                                      FLAGS_admission_tenant_qps / kSecToNs);
+    bucket->refilled_at_ns = now_ns;
+  };
+  auto it = token_buckets_.find(tenant);
+  if (it == token_buckets_.end()) {
+    if (token_buckets_.size() >= FLAGS_admission_max_tenants) {
+      // Tenants whose buckets have refilled are as good as new, so forget
+      // them.
+      absl::erase_if(token_buckets_, [&](auto& entry) {
+        refill(&entry.second);
+        return entry.second.tokens >= burst;
+      });
+    }
+    it = token_buckets_
+             .emplace(tenant,
+                      TokenBucket{.tokens = burst, .refilled_at_ns = now_ns})
+             .first;
+  } else {
+    refill(&it->second);
+  }
+  if (it->second.tokens < 1) {
+    return false;
+  }
+  it->second.tokens -= 1;
+  return true;
+}
+
+void AdmissionCtrl::Release() {
+  Waiter* next = nullptr;
+  {
+    std::lock_guard lock(mutex_);
+    ClassState* next_class = nullptr;
+    double next_finish_vtime = 0;
+    for (auto& state : classes_) {
+      if (state.waiters.empty()) {
+        continue;
+      }
+      auto finish_vtime = state.last_finish_vtime + 1 / state.weight;
+      if (next_class == nullptr || finish_vtime < next_finish_vtime) {
+        next_class = &state;
+        next_finish_vtime = finish_vtime;
+      }
+    }
+    if (next_class == nullptr) {
+      CHECK_GT(inflight_, 0);
+      inflight_--;
+      inflight_gauge_->Set(inflight_);
+      return;
+    }
+    vtime_ = next_finish_vtime;
+    next_class->last_finish_vtime = next_finish_vtime;
+    next = next_class->waiters.front();
+    next_class->waiters.pop_front();
+    next_class->queue_depth->Decrement();
+    next_class->admitted->Increment();
+  }
+  next->admitted.set();
+}
+
+}  // namespace rocketfs
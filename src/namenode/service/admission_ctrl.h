@@ -0,0 +1,105 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <agrpc/asio_grpc.hpp>
+#include <unifex/async_manual_reset_event.hpp>
+#include <unifex/task.hpp>
+
+#include "common/status.h"
+#include "common/time_util.h"
+
+namespace rocketfs {
+
+enum class OpClass : uint8_t {
+  kRead = 0,
+  kMutation = 1,
+  kListing = 2,
+};
+constexpr size_t kOpClassNum = 3;
+
+// Decides which reqs run and when, before they touch the KV store:
+// - Every tenant, i.e., uid or client, is rate limited by its own token
+//   bucket (`admission_tenant_qps`).
+// - At most `admission_max_inflight_ops` ops run at once. The others wait in
+//   one queue per op class and are dispatched by weighted fair queuing, so a
+//   flood of one class, e.g., the listings of a `find`, cannot starve the
+//   others.
+// Reqs over the rate or beyond a full queue are shed with `ThrottledError`,
+// which clients retry after a backoff.
+class AdmissionCtrl {
+ public:
+  // Holds an inflight slot until destroyed.
+  class Permit {
+   public:
+    explicit Permit(AdmissionCtrl* admission_ctrl);
+    Permit(const Permit&) = delete;
+    Permit(Permit&& other);
+    Permit& operator=(const Permit&) = delete;
+    Permit& operator=(Permit&&) = delete;
+    ~Permit();
+
+   private:
+    AdmissionCtrl* admission_ctrl_;
+  };
+
+  explicit AdmissionCtrl(TimeUtilBase* time_util);
+  AdmissionCtrl(const AdmissionCtrl&) = delete;
+  AdmissionCtrl(AdmissionCtrl&&) = delete;
+  AdmissionCtrl& operator=(const AdmissionCtrl&) = delete;
+  AdmissionCtrl& operator=(AdmissionCtrl&&) = delete;
+  ~AdmissionCtrl() = default;
+
+  // Called on `grpc_ctx`, where a queued op resumes once admitted.
+  unifex::task<std::expected<Permit, Status>> Admit(
+      OpClass op_class, std::string_view tenant, agrpc::GrpcContext* grpc_ctx);
+
+ private:
+  struct TokenBucket {
+    double tokens;
+    int64_t refilled_at_ns;
+  };
+
+  struct Waiter {
+    unifex::async_manual_reset_event admitted;
+  };
+
+  struct ClassState {
+    std::deque<Waiter*> waiters;
+    double weight{1};
+    // The virtual finish time of the last op of this class dispatched from
+    // the queue. An op takes 1 / `weight` of virtual time.
+    double last_finish_vtime{0};
+    prometheus::Gauge* queue_depth{nullptr};
+    prometheus::Counter* admitted{nullptr};
+    prometheus::Counter* rate_limited{nullptr};
+    prometheus::Counter* queue_full{nullptr};
+  };
+
+  bool TakeToken(std::string_view tenant);
+  void Release();
+
+ private:
+  TimeUtilBase* time_util_;
+  std::mutex mutex_;
+  absl::flat_hash_map<std::string, TokenBucket> token_buckets_;
+  size_t inflight_{0};
+  double vtime_{0};
+  std::array<ClassState, kOpClassNum> classes_;
+  prometheus::Gauge* inflight_gauge_;
+};
+
+}  // namespace rocketfs
@@ -0,0 +1,157 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/service/conflict_retrier.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <gflags/gflags.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "common/logger.h"
+#include "common/time_util.h"
+#include "namenode/common/metrics.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(op_conflict_max_retries);
+DECLARE_uint32(op_conflict_backoff_base_us);
+DECLARE_uint32(op_conflict_backoff_max_us);
+DECLARE_uint32(op_conflict_aging_retries);
+
+namespace {
+
+// Counts the aged ops per dir. Shared by the ops of every RPC type, since
+// those under one dir conflict with each other.
+class AgingGate {
+ public:
+  AgingGate();
+  AgingGate(const AgingGate&) = delete;
+  AgingGate(AgingGate&&) = delete;
+  AgingGate& operator=(const AgingGate&) = delete;
+  AgingGate& operator=(AgingGate&&) = delete;
+  ~AgingGate() = default;
+
+  bool HasAgedOps(InodeID dir);
+  void Enter(InodeID dir);
+  void Leave(InodeID dir);
+
+ private:
+  std::mutex mutex_;
+  // Only changed under `mutex_`, but read without it on the fast path.
+  std::atomic<size_t> total_aged_ops_{0};
+  absl::flat_hash_map<uint64_t, size_t> aged_ops_;
+  prometheus::Gauge* aged_ops_gauge_;
+};
+
+AgingGate::AgingGate()
+    : aged_ops_gauge_(&prometheus::BuildGauge()
+                           .Name("rocketfs_op_conflict_aged_ops")
+                           .Help("The num of ops retrying with priority "
+                                 "after repeated conflicts.")
+                           .Register(GetMetricsRegistry())
+                           .Add({})) {
+}
+
+bool AgingGate::HasAgedOps(InodeID dir) {
+  if (total_aged_ops_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  std::lock_guard lock(mutex_);
+  return aged_ops_.contains(dir.val);
+}
+
+void AgingGate::Enter(InodeID dir) {
+  std::lock_guard lock(mutex_);
+  aged_ops_[dir.val]++;
+  total_aged_ops_.fetch_add(1, std::memory_order_relaxed);
+  aged_ops_gauge_->Increment();
+}
+
+void AgingGate::Leave(InodeID dir) {
+  std::lock_guard lock(mutex_);
+  auto it = aged_ops_.find(dir.val);
+  CHECK(it != aged_ops_.end());
+  if (--it->second == 0) {
+    aged_ops_.erase(it);
+  }
+  total_aged_ops_.fetch_sub(1, std::memory_order_relaxed);
+  aged_ops_gauge_->Decrement();
+}
+
+AgingGate& GetAgingGate() {
+  static AgingGate aging_gate;
+  return aging_gate;
+}
+
+}  // namespace
+
+ConflictRetrier::Aged::Aged(InodeID dir) : dir_(dir) {
+  GetAgingGate().Enter(dir_);
+}
+
+ConflictRetrier::Aged::~Aged() {
+  GetAgingGate().Leave(dir_);
+}
+
+ConflictRetrier::ConflictRetrier(std::string_view rpc_name) {
+  auto& registry = GetMetricsRegistry();
+  conflicts_ = &prometheus::BuildCounter()
+                    .Name("rocketfs_op_conflicts_total")
+                    .Help("The num of op attempts whose txns failed to "
+                          "commit with ConflictError.")
+                    .Register(registry)
+                    .Add({{"rpc", std::string(rpc_name)}});
+  retries_ = &prometheus::BuildCounter()
+                  .Name("rocketfs_op_conflict_retries_total")
+                  .Help("The num of op attempts retried after a conflict.")
+                  .Register(registry)
+                  .Add({{"rpc", std::string(rpc_name)}});
+  exhausted_ = &prometheus::BuildCounter()
+                    .Name("rocketfs_op_conflict_exhausted_total")
+                    .Help("The num of ops that failed with ConflictError "
+                          "after running out of retries.")
+                    .Register(registry)
+                    .Add({{"rpc", std::string(rpc_name)}});
+}
+
+bool ConflictRetrier::HasAgedOps(InodeID dir) const {
+  return GetAgingGate().HasAgedOps(dir);
+}
+
+int64_t ConflictRetrier::GetAgedPollNs() const {
+  return static_cast<int64_t>(FLAGS_op_conflict_backoff_base_us) * kUsToNs;
+}
+
+std::optional<int64_t> ConflictRetrier::OnConflict(uint32_t retries) {
+  conflicts_->Increment();
+  if (retries >= FLAGS_op_conflict_max_retries) {
+    exhausted_->Increment();
+    return std::nullopt;
+  }
+  retries_->Increment();
+  auto max_backoff_us = std::min<int64_t>(
+      FLAGS_op_conflict_backoff_max_us,
+      static_cast<int64_t>(FLAGS_op_conflict_backoff_base_us)
+          << std::min<uint32_t>(retries, 20));
+  thread_local std::mt19937_64 rng(std::random_device{}());
+  return std::uniform_int_distribution<int64_t>(0, max_backoff_us)(rng) *
+         kUsToNs;
+}
+
+bool ConflictRetrier::IsAged(uint32_t retries) const {
+  return FLAGS_op_conflict_aging_retries > 0 &&
+         retries >= FLAGS_op_conflict_aging_retries;
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,65 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <prometheus/counter.h>
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+// Decides whether and when the ops of one RPC type run again after their txns
+// fail to commit with `ConflictError`, e.g., when many clients create entries
+// in one hot dir:
+// - A retry backs off by a random delay of up to `op_conflict_backoff_base_us`
+//   doubled per retry, so the ops that collided spread out.
+// - An op is retried at most `op_conflict_max_retries` times.
+// - An op aborted `op_conflict_aging_retries` times ages. While an aged op
+//   runs, no mutation of any RPC type under the same dir starts its first
+//   attempt, so the aged ones stop losing to a stream of fresh ones. Ops
+//   under other dirs are not held back.
+class ConflictRetrier {
+ public:
+  // Marks an op that mutates entries under `dir` as aged until destroyed.
+  class Aged {
+   public:
+    explicit Aged(InodeID dir);
+    Aged(const Aged&) = delete;
+    Aged(Aged&&) = delete;
+    Aged& operator=(const Aged&) = delete;
+    Aged& operator=(Aged&&) = delete;
+    ~Aged();
+
+   private:
+    const InodeID dir_;
+  };
+
+  explicit ConflictRetrier(std::string_view rpc_name);
+  ConflictRetrier(const ConflictRetrier&) = delete;
+  ConflictRetrier(ConflictRetrier&&) = delete;
+  ConflictRetrier& operator=(const ConflictRetrier&) = delete;
+  ConflictRetrier& operator=(ConflictRetrier&&) = delete;
+  ~ConflictRetrier() = default;
+
+  // Whether an aged op under `dir` runs. Checked before the first attempt of
+  // an op, which polls every `GetAgedPollNs` ns until none does.
+  bool HasAgedOps(InodeID dir) const;
+  int64_t GetAgedPollNs() const;
+
+  // Returns the backoff in ns before retrying an op whose attempt `retries`
+  // (0 for the first one) has just conflicted, or std::nullopt if the op has
+  // run out of retries.
+  std::optional<int64_t> OnConflict(uint32_t retries);
+  bool IsAged(uint32_t retries) const;
+
+ private:
+  prometheus::Counter* conflicts_;
+  prometheus::Counter* retries_;
+  prometheus::Counter* exhausted_;
+};
+
+}  // namespace rocketfs
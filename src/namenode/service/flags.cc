@@ -6,7 +6,70 @@ namespace rocketfs {
 
 DEFINE_uint32(request_monotonic_buffer_resource_prealloc_bytes,
               4096,
-              "Preallocate memory (in bytes) for the monotonic buffer resource "
-              "used by a req.");
+              "The arena size (in bytes) reqs of every RPC type start with, "
+              "until the sizes they need are learned.");
+DEFINE_uint32(namenode_grpc_threads,
+              0,
+              "The num of threads serving RPCs, each with its own completion "
+              "queue. 0 means one per hardware thread.");
+DEFINE_bool(namenode_pin_grpc_threads,
+            false,
+            "Pin every thread serving RPCs to its own CPU.");
+DEFINE_bool(namenode_offload_ops,
+            true,
+            "Run ops on a work-stealing pool rather than on the thread "
+            "serving the RPC, so that long ops do not delay other RPCs.");
+DEFINE_uint32(namenode_op_threads,
+              0,
+              "The num of threads in the pool ops are offloaded to. 0 means "
+              "one per hardware thread.");
+DEFINE_uint32(admission_tenant_qps,
+              0,
+              "The num of reqs per second each uid, or each client for reqs "
+              "without a uid, may issue. 0 means unlimited.");
+DEFINE_uint32(admission_tenant_burst,
+              1000,
+              "The num of reqs a tenant may issue at once above its rate.");
+DEFINE_uint32(admission_max_tenants,
+              100'000,
+              "The num of tenants whose rates are tracked before idle ones "
+              "are forgotten.");
+DEFINE_uint32(admission_max_inflight_ops,
+              1024,
+              "The max num of ops running at once. Further ops are queued. 0 "
+              "means unlimited.");
+DEFINE_uint32(admission_max_queued_ops,
+              4096,
+              "The max num of ops of each op class waiting to be admitted. "
+              "Further ops are shed.");
+DEFINE_uint32(admission_read_weight,
+              4,
+              "The share of queued reads, e.g., GetInode and Lookup, "
+              "admitted relative to the other op classes.");
+DEFINE_uint32(admission_mutation_weight,
+              2,
+              "The share of queued mutations, e.g., Mkdirs, admitted relative "
+              "to the other op classes.");
+DEFINE_uint32(admission_listing_weight,
+              1,
+              "The share of queued listings, i.e., ListDir, admitted relative "
+              "to the other op classes.");
+DEFINE_uint32(op_conflict_max_retries,
+              8,
+              "The max num of times an op whose txn fails to commit with "
+              "ConflictError is retried against a fresh txn.");
+DEFINE_uint32(op_conflict_backoff_base_us,
+              100,
+              "The max backoff (in microseconds) before the first retry of "
+              "a conflicting op. It doubles with every further retry.");
+DEFINE_uint32(op_conflict_backoff_max_us,
+              10'000,
+              "The cap (in microseconds) on the backoff between retries of a "
+              "conflicting op.");
+DEFINE_uint32(op_conflict_aging_retries,
+              3,
+              "The num of retries after which a conflicting op takes "
+              "priority: no other mutation under the same dir starts until "
+              "it finishes. 0 disables aging.");
 
 }  // namespace rocketfs
@@ -2,56 +2,64 @@
 
 #include "namenode/service/handler_ctx.h"
 
-#include <gflags/gflags.h>
-
+#include <cstdint>
 #include <memory>
 #include <utility>
 
 #include "common/logger.h"
+#include "namenode/common/req_arena.h"
 #include "namenode/table/kv/kv_dent_view.h"
 #include "namenode/table/kv/kv_dir_table.h"
+#include "namenode/table/kv/layout.h"
 
 namespace rocketfs {
 
-DECLARE_uint32(request_monotonic_buffer_resource_prealloc_bytes);
-
-HandlerCtx::HandlerCtx(NameNodeCtx* namenode_ctx)
-    : namenode_ctx_(namenode_ctx),
-      request_monotonic_buffer_resource_prealloc_bytes_(
-          FLAGS_request_monotonic_buffer_resource_prealloc_bytes),
-      memory_resource_holder_(std::make_unique<std::byte[]>(
-          request_monotonic_buffer_resource_prealloc_bytes_)),
-      monotonic_buffer_resource_(
-          memory_resource_holder_.get(),
-          request_monotonic_buffer_resource_prealloc_bytes_),
-      alloc_(&monotonic_buffer_resource_),
-      txn_(namenode_ctx_->GetKVStore()->StartTxn(alloc_)),
-      dir_table_(std::make_unique<KVDirTable>(txn_.get(), alloc_)),
-      dent_view_(std::make_unique<KVDEntView>(txn_.get(), alloc_)) {
-  CHECK_NOTNULL(namenode_ctx_);
-  CHECK_GT(request_monotonic_buffer_resource_prealloc_bytes_, 0);
-  CHECK_NOTNULL(memory_resource_holder_);
-  CHECK_NOTNULL(txn_);
-  CHECK_NOTNULL(dir_table_);
-  // CHECK_NOTNULL(file_table_);
-  // CHECK_NOTNULL(hard_link_table_);
-  CHECK_NOTNULL(dent_view_);
+HandlerCtx::HandlerCtx(NameNodeCtx* namenode_ctx,
+                       Deadline deadline,
+                       ArenaSizer* arena_sizer)
+    : namenode_ctx_(CHECK_NOTNULL(namenode_ctx)),
+      deadline_(deadline),
+      arena_(arena_sizer),
+      alloc_(&arena_) {
 }
 
 NameNodeCtx* HandlerCtx::GetCtx() {
   return namenode_ctx_;
 }
 
+const Deadline& HandlerCtx::GetDeadline() const {
+  return deadline_;
+}
+
 std::unique_ptr<TxnBase> HandlerCtx::GetTxn() {
+  StartTxn();
   return std::move(txn_);
 }
 
+bool HandlerCtx::StartTxnAt(int64_t read_version) {
+  Check(!txn_started_, "The txn has started.");
+  txn_ = namenode_ctx_->GetKVStore()->StartTxnAt(alloc_, read_version);
+  if (txn_ == nullptr) {
+    return false;
+  }
+  txn_->SetDeadline(deadline_);
+  txn_started_ = true;
+  return true;
+}
+
+int64_t HandlerCtx::RetainSnapshot() {
+  return namenode_ctx_->GetKVStore()->RetainSnapshot(StartTxn());
+}
+
 ReqScopedAlloc HandlerCtx::GetAlloc() {
   return alloc_;
 }
 
 DirTableBase* HandlerCtx::GetDirTable() {
-  return dir_table_.get();
+  if (!dir_table_) {
+    dir_table_.emplace(StartTxn(), alloc_, GetDirLayout());
+  }
+  return &*dir_table_;
 }
 
 FileTableBase* HandlerCtx::GetFileTable() {
@@ -63,7 +71,21 @@ HardLinkTableBase* HandlerCtx::GetHardLinkTable() {
 }
 
 DEntViewBase* HandlerCtx::GetDEntView() {
-  return dent_view_.get();
+  if (!dent_view_) {
+    dent_view_.emplace(StartTxn(), alloc_);
+  }
+  return &*dent_view_;
+}
+
+TxnBase* HandlerCtx::StartTxn() {
+  if (!txn_started_) {
+    txn_ = namenode_ctx_->GetKVStore()->StartTxn(alloc_);
+    CHECK_NOTNULL(txn_);
+    txn_->SetDeadline(deadline_);
+    txn_started_ = true;
+  }
+  Check(txn_ != nullptr, "The txn is used after it is taken.");
+  return txn_.get();
 }
 
 }  // namespace rocketfs
@@ -4,20 +4,46 @@
 #include <cstdint>
 #include <memory>
 #include <memory_resource>
+#include <optional>
 
+#include "namenode/common/deadline.h"
+#include "namenode/common/req_arena.h"
 #include "namenode/common/req_scoped_alloc.h"
 #include "namenode/namenode_ctx.h"
 #include "namenode/table/dent_view_base.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/file_table_base.h"
 #include "namenode/table/hard_link_table_base.h"
+#include "namenode/table/kv/kv_dent_view.h"
+#include "namenode/table/kv/kv_dir_table.h"
 #include "namenode/table/kv/kv_store_base.h"
 
 namespace rocketfs {
 
+// The components of `HandlerCtx` an op uses, declared at compile time through
+// `OpBase`. An op can only reach the components it declares.
+struct HandlerParts {
+  // The arena of the req, for what the op allocates itself.
+  bool alloc{false};
+  // The txn itself, e.g., to commit it.
+  bool txn{false};
+  bool dir_table{false};
+  bool dent_view{false};
+
+  // Ops that touch no KV never block.
+  constexpr bool NeedsKV() const {
+    return txn || dir_table || dent_view;
+  }
+};
+
+// Every component is built in place on first use, so a req that fails early or
+// needs nothing, e.g., PingPong, does not start a txn or touch the arena.
 class HandlerCtx {
  public:
-  explicit HandlerCtx(NameNodeCtx* namenode_ctx);
+  // `arena_sizer` sizes the arena of the req, see `OpBase::GetArenaSizer`.
+  HandlerCtx(NameNodeCtx* namenode_ctx,
+             Deadline deadline,
+             ArenaSizer* arena_sizer);
   HandlerCtx(const HandlerCtx&) = delete;
   HandlerCtx(HandlerCtx&&) = delete;
   HandlerCtx& operator=(const HandlerCtx&) = delete;
@@ -25,26 +51,39 @@ class HandlerCtx {
   ~HandlerCtx() = default;
 
   NameNodeCtx* GetCtx();
+  const Deadline& GetDeadline() const;
+  // The tables must not be used after the txn is taken.
   std::unique_ptr<TxnBase> GetTxn();
+  // Starts the txn at the snapshot `KVStoreBase::RetainSnapshot` returned
+  // `read_version` for. Returns false if it is no longer retained, in which
+  // case the txn starts at a new snapshot on first use as usual. Must be
+  // called before anything else uses the txn.
+  bool StartTxnAt(int64_t read_version);
+  // See `KVStoreBase::RetainSnapshot`.
+  int64_t RetainSnapshot();
   ReqScopedAlloc GetAlloc();
   DirTableBase* GetDirTable();
   FileTableBase* GetFileTable();
   HardLinkTableBase* GetHardLinkTable();
   DEntViewBase* GetDEntView();
 
+ private:
+  TxnBase* StartTxn();
+
  private:
   NameNodeCtx* namenode_ctx_;
+  Deadline deadline_;
 
-  uint32_t request_monotonic_buffer_resource_prealloc_bytes_;
-  std::unique_ptr<std::byte[]> memory_resource_holder_;
-  std::pmr::monotonic_buffer_resource monotonic_buffer_resource_;
+  // Takes no buffer before the first allocation.
+  ReqArena arena_;
   ReqScopedAlloc alloc_;
 
+  bool txn_started_{false};
   std::unique_ptr<TxnBase> txn_;
-  std::unique_ptr<DirTableBase> dir_table_;
+  std::optional<KVDirTable> dir_table_;
   std::unique_ptr<FileTableBase> file_table_;
   std::unique_ptr<HardLinkTableBase> hard_link_table_;
-  std::unique_ptr<DEntViewBase> dent_view_;
+  std::optional<KVDEntView> dent_view_;
 };
 
 }  // namespace rocketfs
@@ -0,0 +1,493 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/service/namenode_server.h"
+
+#include <fmt/core.h>
+#include <gflags/gflags.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/support/status.h>
+#include <pthread.h>
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+#include <sched.h>
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <agrpc/asio_grpc.hpp>
+#include <unifex/finally.hpp>
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/just_from.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/task.hpp>
+#include <unifex/when_all.hpp>
+#include <unifex/with_query_value.hpp>
+
+#include "common/logger.h"
+#include "namenode/common/deadline.h"
+#include "namenode/service/admission_ctrl.h"
+#include "namenode/service/operation/batch_get_inode_op.h"
+#include "namenode/service/operation/batch_lookup_op.h"
+#include "namenode/service/operation/bulk_create_op.h"
+#include "namenode/service/operation/get_inode_op.h"
+#include "namenode/service/operation/list_dir_op.h"
+#include "namenode/service/operation/list_dir_stream_op.h"
+#include "namenode/service/operation/lookup_op.h"
+#include "namenode/service/operation/mkdirs_op.h"
+#include "namenode/service/operation/ping_pong_op.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(namenode_grpc_threads);
+DECLARE_bool(namenode_pin_grpc_threads);
+DECLARE_bool(namenode_offload_ops);
+DECLARE_uint32(namenode_op_threads);
+
+namespace {
+
+template <typename Sender>
+void RunGrpcCtxForSender(agrpc::GrpcContext* grpc_ctx, Sender&& sender) {
+  CHECK_NOTNULL(grpc_ctx);
+  grpc_ctx->work_started();
+  unifex::sync_wait(unifex::when_all(
+      unifex::finally(std::forward<Sender>(sender),
+                      unifex::just_from([&] { grpc_ctx->work_finished(); })),
+      unifex::just_from([&] { grpc_ctx->run(); })));
+}
+
+// Reqs carrying a uid are accounted to it, and the others to their client.
+template <typename Rpc>
+std::string GetTenant(Rpc& rpc, const typename Rpc::Request& req) {
+  if constexpr (requires { req.uid(); }) {
+    return fmt::format("uid:{}", req.uid());
+  } else {
+    return rpc.context().peer();
+  }
+}
+
+// The deadline the client set, if any, as told by the clock of `namenode_ctx`.
+Deadline GetDeadline(const grpc::ServerContext& ctx,
+                     NameNodeCtx* namenode_ctx) {
+  auto deadline = ctx.deadline();
+  if (deadline == std::chrono::system_clock::time_point::max()) {
+    return Deadline();
+  }
+  return Deadline(namenode_ctx->GetTimeUtil(),
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      deadline.time_since_epoch())
+                      .count());
+}
+
+// Admits `req` through `admission_ctrl`, or returns the resp to reply with if
+// it is shed or its deadline expires while it waits in the admission queue.
+template <typename Rpc>
+unifex::task<
+    std::expected<AdmissionCtrl::Permit, typename Rpc::Response>>
+Admit(AdmissionCtrl* admission_ctrl,
+      agrpc::GrpcContext* grpc_ctx,
+      OpClass op_class,
+      Rpc& rpc,
+      const typename Rpc::Request& req,
+      const Deadline& deadline) {
+  auto admitted = co_await CHECK_NOTNULL(admission_ctrl)
+                      ->Admit(op_class, GetTenant(rpc, req), grpc_ctx);
+  if (!admitted) {
+    LOG_DEBUG(logger, "{}", admitted.error().GetMsg());
+    co_return std::unexpected(
+        admitted.error().template MakeError<typename Rpc::Response>());
+  }
+  if (auto alive = deadline.Check(); !alive) {
+    LOG_DEBUG(logger, "{}", alive.error().GetMsg());
+    co_return std::unexpected(
+        alive.error().template MakeError<typename Rpc::Response>());
+  }
+  co_return std::move(*admitted);
+}
+
+// Returns how ops retried on conflicts wait out their backoffs: on `grpc_ctx`,
+// hopping back to `pool` afterwards if there is one.
+auto MakeBackoffSleep(agrpc::GrpcContext* grpc_ctx,
+                      unifex::static_thread_pool* pool) {
+  return [grpc_ctx, pool](int64_t backoff_ns) -> unifex::task<void> {
+    agrpc::Alarm alarm(*grpc_ctx);
+    co_await alarm.wait(std::chrono::system_clock::now() +
+                            std::chrono::nanoseconds(backoff_ns),
+                        agrpc::use_sender);
+    if (pool != nullptr) {
+      co_await unifex::schedule(pool->get_scheduler());
+    }
+  };
+}
+
+// Admits the op through `admission_ctrl` if there is one and the resp can
+// carry `ThrottledError`, runs it on `op_pool` if there is one and the op
+// touches KV, retrying it on conflicts, and finishes the RPC on `grpc_ctx`
+// either way. Backoffs are waited out on `grpc_ctx`.
+template <typename Rpc, typename Operation>
+auto RegisterRpcHandler(agrpc::GrpcContext* grpc_ctx,
+                        unifex::static_thread_pool* op_pool,
+                        AdmissionCtrl* admission_ctrl,
+                        OpClass op_class,
+                        ClientNamenodeService::AsyncService* service,
+                        NameNodeCtx* namenode_ctx) {
+  return agrpc::register_sender_rpc_handler<Rpc>(
+      *grpc_ctx,
+      *service,
+      [grpc_ctx, op_pool, admission_ctrl, op_class, namenode_ctx](
+          Rpc& rpc, const Rpc::Request& req) -> unifex::task<void> {
+        auto deadline = GetDeadline(rpc.context(), namenode_ctx);
+        std::optional<AdmissionCtrl::Permit> permit;
+        if constexpr (requires(typename Rpc::Response resp) {
+                        resp.set_error_code(0);
+                      }) {
+          if (admission_ctrl != nullptr) {
+            auto admitted = co_await Admit(
+                admission_ctrl, grpc_ctx, op_class, rpc, req, deadline);
+            if (!admitted) {
+              co_await rpc.finish(admitted.error(), grpc::Status::OK);
+              co_return;
+            }
+            permit.emplace(std::move(*admitted));
+          }
+        }
+        // Ops that touch no KV never block, so they run inline rather than
+        // pay for two hops.
+        auto* pool = Operation::kHandlerParts.NeedsKV() ? op_pool : nullptr;
+        if (pool != nullptr) {
+          co_await unifex::schedule(pool->get_scheduler());
+        }
+        typename Rpc::Response resp;
+        if constexpr (Operation::kHandlerParts.txn) {
+          // Only ops that commit txns can conflict.
+          resp = co_await Operation::template RunWithRetries<Operation>(
+              namenode_ctx, req, deadline, MakeBackoffSleep(grpc_ctx, pool));
+        } else {
+          resp = co_await Operation(namenode_ctx, req, deadline).Run();
+        }
+        permit.reset();
+        if (pool != nullptr) {
+          co_await unifex::schedule(grpc_ctx->get_scheduler());
+        }
+        co_await rpc.finish(resp, grpc::Status::OK);
+      });
+}
+
+// Like `RegisterRpcHandler`, but for server-streaming RPCs. The op is admitted
+// once and holds its permit for the whole stream. Each chunk is read on
+// `op_pool` if there is one and written from `grpc_ctx`, and the next chunk is
+// read only once the write completes, so a slow reader holds the op back
+// rather than having chunks pile up in memory. The op is also built and
+// destroyed on `op_pool`, where its arena grows, see `ArenaPool`.
+template <typename Rpc, typename Operation>
+auto RegisterStreamRpcHandler(agrpc::GrpcContext* grpc_ctx,
+                              unifex::static_thread_pool* op_pool,
+                              AdmissionCtrl* admission_ctrl,
+                              OpClass op_class,
+                              ClientNamenodeService::AsyncService* service,
+                              NameNodeCtx* namenode_ctx) {
+  return agrpc::register_sender_rpc_handler<Rpc>(
+      *grpc_ctx,
+      *service,
+      [grpc_ctx, op_pool, admission_ctrl, op_class, namenode_ctx](
+          Rpc& rpc, const Rpc::Request& req) -> unifex::task<void> {
+        auto deadline = GetDeadline(rpc.context(), namenode_ctx);
+        auto permit = co_await Admit(
+            admission_ctrl, grpc_ctx, op_class, rpc, req, deadline);
+        if (!permit) {
+          co_await rpc.write(permit.error());
+          co_await rpc.finish(grpc::Status::OK);
+          co_return;
+        }
+        if (op_pool != nullptr) {
+          co_await unifex::schedule(op_pool->get_scheduler());
+        }
+        std::optional<Operation> op;
+        op.emplace(namenode_ctx, req, deadline);
+        for (bool has_more = true; has_more;) {
+          auto resp = co_await op->Next();
+          has_more = resp.has_more();
+          if (!has_more) {
+            op.reset();
+          }
+          if (op_pool != nullptr) {
+            co_await unifex::schedule(grpc_ctx->get_scheduler());
+          }
+          if (!co_await rpc.write(resp)) {
+            // The client is gone.
+            break;
+          }
+          if (op_pool != nullptr && has_more) {
+            co_await unifex::schedule(op_pool->get_scheduler());
+          }
+        }
+        if (op) {
+          // Cut short by the client.
+          if (op_pool != nullptr) {
+            co_await unifex::schedule(op_pool->get_scheduler());
+          }
+          op.reset();
+          if (op_pool != nullptr) {
+            co_await unifex::schedule(grpc_ctx->get_scheduler());
+          }
+          co_return;
+        }
+        co_await rpc.finish(grpc::Status::OK);
+      });
+}
+
+// Runs a chunk of a BulkCreate stream on `op_pool` if there is one, retried
+// on conflicts like `RegisterRpcHandler` does, and returns the resp to reply
+// with on `grpc_ctx`.
+unifex::task<BulkCreateRPC::Response> RunBulkCreateChunk(
+    agrpc::GrpcContext* grpc_ctx,
+    unifex::static_thread_pool* op_pool,
+    NameNodeCtx* namenode_ctx,
+    const BulkCreateRPC::Request& chunk,
+    const Deadline& deadline,
+    BulkCreateBatcher* batcher) {
+  if (op_pool != nullptr) {
+    co_await unifex::schedule(op_pool->get_scheduler());
+  }
+  auto resp = co_await BulkCreateOp::RunWithRetries<BulkCreateOp>(
+      namenode_ctx, chunk, deadline, MakeBackoffSleep(grpc_ctx, op_pool));
+  if (op_pool != nullptr) {
+    co_await unifex::schedule(grpc_ctx->get_scheduler());
+  }
+  co_return batcher->OnChunkDone(resp);
+}
+
+// Handles BulkCreate, whose client stream `BulkCreateBatcher` cuts into
+// chunks, each run by `RunBulkCreateChunk` and replied to with a resp of its
+// own. The stream is admitted once, on its first req. Every full chunk queued
+// is run and its resp written before the next req is read, so a client
+// writing faster than the chunks commit, or reading their resps slower, is
+// held back by flow control rather than queued in memory.
+auto RegisterBulkCreateRpcHandler(agrpc::GrpcContext* grpc_ctx,
+                                  unifex::static_thread_pool* op_pool,
+                                  AdmissionCtrl* admission_ctrl,
+                                  ClientNamenodeService::AsyncService* service,
+                                  NameNodeCtx* namenode_ctx) {
+  return agrpc::register_sender_rpc_handler<BulkCreateRPC>(
+      *grpc_ctx,
+      *service,
+      [grpc_ctx, op_pool, admission_ctrl, namenode_ctx](
+          BulkCreateRPC& rpc) -> unifex::task<void> {
+        auto deadline = GetDeadline(rpc.context(), namenode_ctx);
+        BulkCreateRPC::Request req;
+        BulkCreateBatcher batcher;
+        std::optional<AdmissionCtrl::Permit> permit;
+        while (co_await rpc.read(req)) {
+          if (!permit) {
+            auto admitted = co_await Admit(admission_ctrl,
+                                           grpc_ctx,
+                                           OpClass::kMutation,
+                                           rpc,
+                                           req,
+                                           deadline);
+            if (!admitted) {
+              co_await rpc.write(admitted.error());
+              co_await rpc.finish(grpc::Status::OK);
+              co_return;
+            }
+            permit.emplace(std::move(*admitted));
+          }
+          if (auto added = batcher.Add(req); !added) {
+            LOG_DEBUG(logger, "{}", added.error().GetMsg());
+            co_await rpc.write(
+                added.error().MakeError<BulkCreateRPC::Response>());
+            co_await rpc.finish(grpc::Status::OK);
+            co_return;
+          }
+          while (auto chunk = batcher.NextChunk(/*flush=*/false)) {
+            auto resp = co_await RunBulkCreateChunk(
+                grpc_ctx, op_pool, namenode_ctx, *chunk, deadline, &batcher);
+            if (!co_await rpc.write(resp)) {
+              // The client is gone.
+              co_return;
+            }
+          }
+        }
+        while (auto chunk = batcher.NextChunk(/*flush=*/true)) {
+          auto resp = co_await RunBulkCreateChunk(
+              grpc_ctx, op_pool, namenode_ctx, *chunk, deadline, &batcher);
+          if (!co_await rpc.write(resp)) {
+            co_return;
+          }
+        }
+        permit.reset();
+        if (auto resp = batcher.Finish()) {
+          if (!co_await rpc.write(*resp)) {
+            co_return;
+          }
+        }
+        co_await rpc.finish(grpc::Status::OK);
+      });
+}
+
+// Pins the calling thread to the `index`-th CPU the process may run on.
+void PinToCpu(size_t index) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  CHECK_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  auto cpu_num = CPU_COUNT(&allowed);
+  CHECK_GT(cpu_num, 0);
+  auto nth = static_cast<int>(index % cpu_num);
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed) || nth-- > 0) {
+      continue;
+    }
+    cpu_set_t pinned;
+    CPU_ZERO(&pinned);
+    CPU_SET(cpu, &pinned);
+    CHECK_EQ(
+        pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned), 0);
+    LOG_INFO(logger, "gRPC thread {} is pinned to CPU {}.", index, cpu);
+    return;
+  }
+}
+
+}  // namespace
+
+NameNodeServer::NameNodeServer(NameNodeCtx* namenode_ctx)
+    : namenode_ctx_(CHECK_NOTNULL(namenode_ctx)),
+      admission_ctrl_(namenode_ctx_->GetTimeUtil()) {
+}
+
+NameNodeServer::~NameNodeServer() {
+  Shutdown();
+  Wait();
+}
+
+void NameNodeServer::Start(const std::string& address) {
+  CHECK_NULL(server_);
+  auto thread_num = FLAGS_namenode_grpc_threads == 0
+                        ? std::thread::hardware_concurrency()
+                        : FLAGS_namenode_grpc_threads;
+  CHECK_GT(thread_num, 0);
+  if (FLAGS_namenode_offload_ops) {
+    op_pool_ = std::make_unique<unifex::static_thread_pool>(
+        FLAGS_namenode_op_threads == 0 ? std::thread::hardware_concurrency()
+                                       : FLAGS_namenode_op_threads);
+  }
+
+  grpc::ServerBuilder builder;
+  for (size_t i = 0; i < thread_num; i++) {
+    grpc_ctxs_.emplace_back(
+        std::make_unique<agrpc::GrpcContext>(builder.AddCompletionQueue()));
+  }
+  builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+  builder.RegisterService(&service_);
+  server_ = builder.BuildAndStart();
+  CHECK_NOTNULL(server_);
+  LOG_INFO(logger,
+           "Namenode is listening on {} with {} gRPC threads, {}.",
+           address,
+           thread_num,
+           op_pool_ == nullptr ? "running ops inline"
+                               : "offloading ops to a thread pool");
+
+  for (size_t i = 0; i < thread_num; i++) {
+    threads_.emplace_back([this, i]() {
+      if (FLAGS_namenode_pin_grpc_threads) {
+        PinToCpu(i);
+      }
+      Run(grpc_ctxs_[i].get());
+    });
+  }
+}
+
+void NameNodeServer::Wait() {
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+}
+
+void NameNodeServer::Shutdown() {
+  if (server_ != nullptr) {
+    server_->Shutdown();
+  }
+}
+
+size_t NameNodeServer::GetThreadNum() const {
+  return grpc_ctxs_.size();
+}
+
+void NameNodeServer::Run(agrpc::GrpcContext* grpc_ctx) {
+  RunGrpcCtxForSender(
+      grpc_ctx,
+      unifex::with_query_value(
+          unifex::when_all(
+              // PingPong is a liveness probe and is never throttled.
+              RegisterRpcHandler<PingPongRPC, PingPongOp>(grpc_ctx,
+                                                          op_pool_.get(),
+                                                          nullptr,
+                                                          OpClass::kRead,
+                                                          &service_,
+                                                          namenode_ctx_),
+              RegisterRpcHandler<GetInodeRPC, GetInodeOp>(grpc_ctx,
+                                                          op_pool_.get(),
+                                                          &admission_ctrl_,
+                                                          OpClass::kRead,
+                                                          &service_,
+                                                          namenode_ctx_),
+              RegisterRpcHandler<LookupRPC, LookupOp>(grpc_ctx,
+                                                      op_pool_.get(),
+                                                      &admission_ctrl_,
+                                                      OpClass::kRead,
+                                                      &service_,
+                                                      namenode_ctx_),
+              RegisterRpcHandler<BatchGetInodeRPC, BatchGetInodeOp>(
+                  grpc_ctx,
+                  op_pool_.get(),
+                  &admission_ctrl_,
+                  OpClass::kRead,
+                  &service_,
+                  namenode_ctx_),
+              RegisterRpcHandler<BatchLookupRPC, BatchLookupOp>(
+                  grpc_ctx,
+                  op_pool_.get(),
+                  &admission_ctrl_,
+                  OpClass::kRead,
+                  &service_,
+                  namenode_ctx_),
+              RegisterRpcHandler<ListDirRPC, ListDirOp>(grpc_ctx,
+                                                        op_pool_.get(),
+                                                        &admission_ctrl_,
+                                                        OpClass::kListing,
+                                                        &service_,
+                                                        namenode_ctx_),
+              RegisterStreamRpcHandler<ListDirStreamRPC, ListDirStreamOp>(
+                  grpc_ctx,
+                  op_pool_.get(),
+                  &admission_ctrl_,
+                  OpClass::kListing,
+                  &service_,
+                  namenode_ctx_),
+              RegisterRpcHandler<MkdirsRPC, MkdirsOp>(grpc_ctx,
+                                                      op_pool_.get(),
+                                                      &admission_ctrl_,
+                                                      OpClass::kMutation,
+                                                      &service_,
+                                                      namenode_ctx_),
+              RegisterBulkCreateRpcHandler(grpc_ctx,
+                                           op_pool_.get(),
+                                           &admission_ctrl_,
+                                           &service_,
+                                           namenode_ctx_)),
+          unifex::get_scheduler,
+          unifex::inline_scheduler{}));
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,59 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <grpcpp/server.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <agrpc/asio_grpc.hpp>
+#include <unifex/static_thread_pool.hpp>
+
+#include "namenode/namenode_ctx.h"
+#include "namenode/service/admission_ctrl.h"
+#include "src/proto/client_namenode.grpc.pb.h"
+
+namespace rocketfs {
+
+// Serves `ClientNamenodeService` on `namenode_grpc_threads` threads. Every
+// thread polls its own completion queue through its own `agrpc::GrpcContext`
+// and registers every RPC handler on it. An RPC runs start to finish on the
+// thread that accepted it, unless `namenode_offload_ops` is set: ops then run
+// on a work-stealing pool, so that a long op does not hold up the other RPCs of
+// the thread that accepted it, and the reply is sent back from that thread.
+// All threads share one `NameNodeCtx`, and every req but PingPong goes through
+// one `AdmissionCtrl` first.
+class NameNodeServer {
+ public:
+  explicit NameNodeServer(NameNodeCtx* namenode_ctx);
+  NameNodeServer(const NameNodeServer&) = delete;
+  NameNodeServer(NameNodeServer&&) = delete;
+  NameNodeServer& operator=(const NameNodeServer&) = delete;
+  NameNodeServer& operator=(NameNodeServer&&) = delete;
+  ~NameNodeServer();
+
+  void Start(const std::string& address);
+  // Blocks until every thread exits, which happens only after `Shutdown`.
+  void Wait();
+  void Shutdown();
+
+  size_t GetThreadNum() const;
+
+ private:
+  void Run(agrpc::GrpcContext* grpc_ctx);
+
+ private:
+  NameNodeCtx* namenode_ctx_;
+  AdmissionCtrl admission_ctrl_;
+  // Outlives the gRPC threads, which may still be handing ops over to it.
+  std::unique_ptr<unifex::static_thread_pool> op_pool_;
+  ClientNamenodeService::AsyncService service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::vector<std::unique_ptr<agrpc::GrpcContext>> grpc_ctxs_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace rocketfs
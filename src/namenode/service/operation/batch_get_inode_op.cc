@@ -0,0 +1,81 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/service/operation/batch_get_inode_op.h"
+
+#include <fmt/base.h>
+#include <gflags/gflags.h>
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unifex/coroutine.hpp>
+
+#include "common/logger.h"
+#include "common/status.h"
+#include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/stat_util.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(batch_max_items);
+
+BatchGetInodeOp::BatchGetInodeOp(NameNodeCtx* namenode_ctx,
+                                 const BatchGetInodeRPC::Request& req,
+                                 Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
+}
+
+unifex::task<BatchGetInodeRPC::Response> BatchGetInodeOp::Run() {
+  if (static_cast<uint32_t>(req_.ids_size()) > FLAGS_batch_max_items) {
+    auto status = Status::InvalidArgumentError(
+        fmt::format("{} ids are more than the max of {}.",
+                    req_.ids_size(),
+                    FLAGS_batch_max_items));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<BatchGetInodeRPC::Response>();
+  }
+  std::pmr::vector<InodeID> ids(GetAlloc());
+  ids.reserve(req_.ids_size());
+  for (auto id : req_.ids()) {
+    ids.push_back(InodeID{id});
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto dirs = co_await GetDirTable()->BatchRead(ids);
+  if (!dirs) {
+    auto status = Status::SystemError(
+        fmt::format("Failed to retrieve {} inodes.", ids.size()),
+        dirs.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<BatchGetInodeRPC::Response>();
+  }
+  BatchGetInodeRPC::Response resp;
+  resp.mutable_items()->Reserve(req_.ids_size());
+  for (size_t i = 0; i < ids.size(); i++) {
+    auto* item = resp.add_items();
+    const auto& dir = (*dirs)[i];
+    if (!dir) {
+      *item = Status::NotFoundError(
+                  fmt::format("Inode {} not found.", ids[i].val))
+                  .MakeError<GetInodeResponse>();
+      continue;
+    }
+    item->set_id(dir->id.val);
+    FillStat(*dir, item->mutable_stat());
+  }
+  co_return resp;
+}
+
+}  // namespace rocketfs
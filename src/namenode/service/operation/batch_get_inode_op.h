@@ -0,0 +1,39 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <agrpc/asio_grpc.hpp>
+#include <unifex/task.hpp>
+
+#include "namenode/common/deadline.h"
+#include "namenode/namenode_ctx.h"
+#include "namenode/service/operation/op_base.h"
+#include "src/proto/client_namenode.grpc.pb.h"
+#include "src/proto/client_namenode.pb.h"
+
+namespace rocketfs {
+
+using BatchGetInodeRPC = agrpc::ServerRPC<
+    &ClientNamenodeService::AsyncService::RequestBatchGetInode>;
+
+// Reads every inode of the req in a single `MultiGet`.
+class BatchGetInodeOp
+    : public OpBase<BatchGetInodeRPC,
+                    HandlerParts{.alloc = true, .dir_table = true}> {
+ public:
+  BatchGetInodeOp(NameNodeCtx* namenode_ctx,
+                  const BatchGetInodeRPC::Request& req,
+                  Deadline deadline);
+  BatchGetInodeOp(const BatchGetInodeOp&) = delete;
+  BatchGetInodeOp(BatchGetInodeOp&&) = delete;
+  BatchGetInodeOp& operator=(const BatchGetInodeOp&) = delete;
+  BatchGetInodeOp& operator=(BatchGetInodeOp&&) = delete;
+  ~BatchGetInodeOp() = default;
+
+  unifex::task<BatchGetInodeRPC::Response> Run();
+
+ private:
+  const BatchGetInodeRPC::Request& req_;
+};
+
+}  // namespace rocketfs
@@ -0,0 +1,144 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/service/operation/batch_lookup_op.h"
+
+#include <fmt/base.h>
+#include <gflags/gflags.h>
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <unifex/coroutine.hpp>
+
+#include "common/logger.h"
+#include "common/status.h"
+#include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/stat_util.h"
+#include "namenode/table/dent_view_base.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/hard_link_table_base.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(batch_max_items);
+
+BatchLookupOp::BatchLookupOp(NameNodeCtx* namenode_ctx,
+                             const BatchLookupRPC::Request& req,
+                             Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
+}
+
+unifex::task<BatchLookupRPC::Response> BatchLookupOp::Run() {
+  if (static_cast<uint32_t>(req_.items_size()) > FLAGS_batch_max_items) {
+    auto status = Status::InvalidArgumentError(
+        fmt::format("{} items are more than the max of {}.",
+                    req_.items_size(),
+                    FLAGS_batch_max_items));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<BatchLookupRPC::Response>();
+  }
+  BatchLookupRPC::Response resp;
+  resp.mutable_items()->Reserve(req_.items_size());
+  // The items with valid names, in the order they are read in.
+  std::pmr::vector<std::pair<InodeID, std::string_view>> names(GetAlloc());
+  std::pmr::vector<int> name_items(GetAlloc());
+  names.reserve(req_.items_size());
+  name_items.reserve(req_.items_size());
+  for (int i = 0; i < req_.items_size(); i++) {
+    const auto& item_req = req_.items(i);
+    auto* item = resp.add_items();
+    auto valid_name = CheckName(item_req.name());
+    if (!valid_name) {
+      *item = valid_name.error().MakeError<LookupResponse>();
+      continue;
+    }
+    names.emplace_back(InodeID{item_req.parent_id()}, item_req.name());
+    name_items.push_back(i);
+  }
+  if (names.empty()) {
+    co_return resp;
+  }
+
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto dents = co_await GetDEntView()->BatchRead(names);
+  if (!dents) {
+    auto status = Status::SystemError(
+        fmt::format("Failed to look up {} names.", names.size()),
+        dents.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<BatchLookupRPC::Response>();
+  }
+  // The dirs whose times are not cached in their entries, see
+  // `dent_cache_dir_times`.
+  std::pmr::vector<InodeID> uncached_ids(GetAlloc());
+  std::pmr::vector<int> uncached_items(GetAlloc());
+  for (size_t j = 0; j < names.size(); j++) {
+    auto* item = resp.mutable_items(name_items[j]);
+    const auto& dent = (*dents)[j];
+    if (std::holds_alternative<std::monostate>(dent)) {
+      *item = Status::NotFoundError(
+                  fmt::format("Parent ID {} and name {} not found.",
+                              names[j].first.val,
+                              names[j].second))
+                  .MakeError<LookupResponse>();
+      continue;
+    }
+    if (std::holds_alternative<const DirView*>(dent)) {
+      const auto& dir = *std::get<const DirView*>(dent);
+      item->set_id(dir.GetID().val);
+      if (!FillStat(dir, item->mutable_stat())) {
+        uncached_ids.push_back(dir.GetID());
+        uncached_items.push_back(name_items[j]);
+      }
+      continue;
+    }
+    CHECK(std::holds_alternative<const HardLinkView*>(dent));
+    const auto& hard_link = *std::get<const HardLinkView*>(dent);
+    item->set_id(hard_link.GetID().val);
+    FillStat(hard_link, item->mutable_stat());
+  }
+  if (uncached_ids.empty()) {
+    co_return resp;
+  }
+
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto dirs = co_await GetDirTable()->BatchRead(uncached_ids);
+  if (!dirs) {
+    auto status = Status::SystemError(
+        fmt::format("Failed to read {} dirs.", uncached_ids.size()),
+        dirs.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<BatchLookupRPC::Response>();
+  }
+  for (size_t k = 0; k < uncached_ids.size(); k++) {
+    auto* item = resp.mutable_items(uncached_items[k]);
+    const auto& dir = (*dirs)[k];
+    if (!dir) {
+      *item = Status::NotFoundError(
+                  fmt::format("Dir {} not found.", uncached_ids[k].val))
+                  .MakeError<LookupResponse>();
+      continue;
+    }
+    item->mutable_stat()->set_mtime_in_ns(dir->mtime_in_ns);
+    item->mutable_stat()->set_atime_in_ns(dir->atime_in_ns);
+  }
+  co_return resp;
+}
+
+}  // namespace rocketfs
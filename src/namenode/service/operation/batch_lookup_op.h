@@ -0,0 +1,41 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <agrpc/asio_grpc.hpp>
+#include <unifex/task.hpp>
+
+#include "namenode/common/deadline.h"
+#include "namenode/namenode_ctx.h"
+#include "namenode/service/operation/op_base.h"
+#include "src/proto/client_namenode.grpc.pb.h"
+#include "src/proto/client_namenode.pb.h"
+
+namespace rocketfs {
+
+using BatchLookupRPC =
+    agrpc::ServerRPC<&ClientNamenodeService::AsyncService::RequestBatchLookup>;
+
+// Reads every dir entry of the req in a single `MultiGet`, and the times of
+// the dirs that do not cache them in another one.
+class BatchLookupOp
+    : public OpBase<
+          BatchLookupRPC,
+          HandlerParts{.alloc = true, .dir_table = true, .dent_view = true}> {
+ public:
+  BatchLookupOp(NameNodeCtx* namenode_ctx,
+                const BatchLookupRPC::Request& req,
+                Deadline deadline);
+  BatchLookupOp(const BatchLookupOp&) = delete;
+  BatchLookupOp(BatchLookupOp&&) = delete;
+  BatchLookupOp& operator=(const BatchLookupOp&) = delete;
+  BatchLookupOp& operator=(BatchLookupOp&&) = delete;
+  ~BatchLookupOp() = default;
+
+  unifex::task<BatchLookupRPC::Response> Run();
+
+ private:
+  const BatchLookupRPC::Request& req_;
+};
+
+}  // namespace rocketfs
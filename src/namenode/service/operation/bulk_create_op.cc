@@ -0,0 +1,358 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/service/operation/bulk_create_op.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <fmt/base.h>
+#include <gflags/gflags.h>
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <unifex/coroutine.hpp>
+
+#include "common/logger.h"
+#include "common/status.h"
+#include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/stat_util.h"
+#include "namenode/table/dent_view_base.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+#include "namenode/table/kv/kv_store_base.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(batch_max_items);
+DECLARE_uint32(bulk_create_chunk_entries);
+DECLARE_uint64(bulk_create_max_entries);
+
+BulkCreateOp::BulkCreateOp(NameNodeCtx* namenode_ctx,
+                           const BulkCreateRPC::Request& req,
+                           Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
+}
+
+unifex::task<BulkCreateRPC::Response> BulkCreateOp::Run() {
+  BulkCreateRPC::Response resp;
+  resp.mutable_items()->Reserve(req_.entries_size());
+  // The distinct existing parents, and the entries under them, which are read
+  // in one batch each.
+  std::pmr::vector<InodeID> parent_ids(GetAlloc());
+  absl::flat_hash_map<uint64_t, size_t> parent_indices;
+  std::pmr::vector<std::pair<InodeID, std::string_view>> names(GetAlloc());
+  std::pmr::vector<int> name_entries(GetAlloc());
+  for (int i = 0; i < req_.entries_size(); i++) {
+    const auto& entry = req_.entries(i);
+    auto* item = resp.add_items();
+    auto type = entry.mode() & S_IFMT;
+    if (type != 0 && type != S_IFDIR) {
+      *item = Status::InvalidArgumentError(
+                  fmt::format("Entry {} is of type {:o}, but only dirs can "
+                              "be created.",
+                              entry.name(),
+                              type))
+                  .MakeError<MkdirsResponse>();
+      continue;
+    }
+    auto valid_name = CheckName(entry.name());
+    if (!valid_name) {
+      *item = valid_name.error().MakeError<MkdirsResponse>();
+      continue;
+    }
+    if (entry.has_parent_entry()) {
+      continue;
+    }
+    if (!entry.has_parent_id()) {
+      *item = Status::InvalidArgumentError(
+                  fmt::format("Entry {} has no parent.", entry.name()))
+                  .MakeError<MkdirsResponse>();
+      continue;
+    }
+    auto parent_id = InodeID{entry.parent_id()};
+    if (parent_indices.try_emplace(parent_id.val, parent_ids.size()).second) {
+      parent_ids.push_back(parent_id);
+    }
+    names.emplace_back(parent_id, entry.name());
+    name_entries.push_back(i);
+  }
+
+  std::pmr::vector<std::optional<Dir>> parents(GetAlloc());
+  if (!parent_ids.empty()) {
+    if (auto expired = CheckDeadline()) {
+      co_return *std::move(expired);
+    }
+    auto parent_dirs = co_await GetDirTable()->BatchRead(parent_ids);
+    if (!parent_dirs) {
+      auto status = Status::SystemError(
+          fmt::format("Failed to read {} parent dirs.", parent_ids.size()),
+          parent_dirs.error());
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return status.MakeError<BulkCreateRPC::Response>();
+    }
+    parents = *std::move(parent_dirs);
+    if (auto expired = CheckDeadline()) {
+      co_return *std::move(expired);
+    }
+    auto dents = co_await GetDEntView()->BatchRead(names);
+    if (!dents) {
+      auto status = Status::SystemError(
+          fmt::format("Failed to look up {} names.", names.size()),
+          dents.error());
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return status.MakeError<BulkCreateRPC::Response>();
+    }
+    for (size_t j = 0; j < names.size(); j++) {
+      if (!std::holds_alternative<std::monostate>((*dents)[j])) {
+        *resp.mutable_items(name_entries[j]) =
+            Status::AlreadyExistsError(
+                fmt::format("Parent ID {} and name {} already exist.",
+                            names[j].first.val,
+                            names[j].second))
+                .MakeError<MkdirsResponse>();
+      }
+    }
+  }
+
+  User user{req_.uid(), req_.gid()};
+  // The dirs created by the chunk, by entry.
+  std::pmr::vector<std::optional<Dir>> created(GetAlloc());
+  created.resize(req_.entries_size());
+  // Rejects entries of the chunk with the same parent and name.
+  absl::flat_hash_set<std::pair<uint64_t, std::string_view>> created_names;
+  // The existing parents any dir is created in.
+  absl::flat_hash_set<uint64_t> changed_parents;
+  auto now_ns = GetCtx()->GetTimeUtil()->NowNs();
+  for (int i = 0; i < req_.entries_size(); i++) {
+    const auto& entry = req_.entries(i);
+    auto* item = resp.mutable_items(i);
+    if (item->error_code() != 0) {
+      continue;
+    }
+    const Dir* parent = nullptr;
+    if (entry.has_parent_entry()) {
+      auto parent_entry = entry.parent_entry();
+      if (parent_entry < static_cast<uint64_t>(i) && created[parent_entry]) {
+        parent = &*created[parent_entry];
+      }
+    } else {
+      const auto& parent_dir = parents[parent_indices.at(entry.parent_id())];
+      if (parent_dir) {
+        parent = &*parent_dir;
+      }
+    }
+    if (parent == nullptr) {
+      *item = Status::ParentNotFoundError(
+                  fmt::format("The parent of entry {} not found.",
+                              entry.name()))
+                  .MakeError<MkdirsResponse>();
+      continue;
+    }
+    auto has_permission =
+        CheckPermission(parent->acl, user, S_IWOTH | S_IXOTH);
+    if (!has_permission) {
+      *item = Status::PermissionError(
+                  fmt::format("Permission denied on parent inode {}.",
+                              parent->id.val),
+                  has_permission.error())
+                  .MakeError<MkdirsResponse>();
+      continue;
+    }
+    if (!created_names.emplace(parent->id.val, entry.name()).second) {
+      *item = Status::AlreadyExistsError(
+                  fmt::format("Parent ID {} and name {} already exist.",
+                              parent->id.val,
+                              entry.name()))
+                  .MakeError<MkdirsResponse>();
+      continue;
+    }
+    auto id = GetCtx()->GetInodeIDGen().Next();
+    if (!id) {
+      auto status =
+          Status::SystemError("Unable to allocate an inode ID.", id.error());
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return status.MakeError<BulkCreateRPC::Response>();
+    }
+    Acl acl{
+        .uid = req_.uid(), .gid = req_.gid(), .perm = entry.mode() & ALLPERMS};
+    if (parent->acl.perm & S_ISGID) {
+      acl.gid = parent->acl.gid;
+      acl.perm |= S_ISGID;
+    }
+    Dir dir{.parent_id = parent->id,
+            .name = std::pmr::string(entry.name(), GetAlloc()),
+            .id = *id,
+            .acl = acl,
+            .ctime_in_ns = now_ns,
+            .mtime_in_ns = now_ns,
+            .atime_in_ns = now_ns};
+    GetDirTable()->Write(std::nullopt, dir);
+    item->set_id(dir.id.val);
+    FillStat(dir, item->mutable_stat());
+    if (entry.has_parent_id()) {
+      changed_parents.insert(entry.parent_id());
+    }
+    created[i] = std::move(dir);
+  }
+  if (std::none_of(created.begin(), created.end(), [](const auto& dir) {
+        return dir.has_value();
+      })) {
+    co_return resp;
+  }
+
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto committed = co_await GetCtx()->GetKVStore()->CommitTxn(GetTxn());
+  if (!committed && committed.error().GetCode() == StatusCode::kConflictError) {
+    // Retried by `RunWithRetries`.
+    co_return committed.error().MakeError<BulkCreateRPC::Response>();
+  }
+  if (!committed) {
+    auto status = Status::SystemError(
+        fmt::format("Failed to create a chunk of {} entries.",
+                    req_.entries_size()),
+        committed.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<BulkCreateRPC::Response>();
+  }
+  for (auto parent_id : changed_parents) {
+    GetCtx()->GetListingCache().Invalidate(InodeID{parent_id});
+  }
+  co_return resp;
+}
+
+InodeID BulkCreateOp::GetContendedDir(const BulkCreateRPC::Request& req) {
+  if (req.entries().empty() || !req.entries(0).has_parent_id()) {
+    return kInvalidInodeID;
+  }
+  return InodeID{req.entries(0).parent_id()};
+}
+
+std::expected<void, Status> BulkCreateBatcher::Add(
+    const BulkCreateRPC::Request& req) {
+  if (static_cast<uint32_t>(req.entries_size()) > FLAGS_batch_max_items) {
+    return std::unexpected(Status::InvalidArgumentError(
+        fmt::format("{} entries in a req are more than the max of {}.",
+                    req.entries_size(),
+                    FLAGS_batch_max_items)));
+  }
+  if (entries_ + req.entries_size() > FLAGS_bulk_create_max_entries) {
+    return std::unexpected(Status::InvalidArgumentError(
+        fmt::format("{} entries in a stream are more than the max of {}.",
+                    entries_ + req.entries_size(),
+                    FLAGS_bulk_create_max_entries)));
+  }
+  if (!uid_gid_) {
+    uid_gid_.emplace(req.uid(), req.gid());
+  }
+  pending_.insert(pending_.end(), req.entries().begin(), req.entries().end());
+  entries_ += req.entries_size();
+  return {};
+}
+
+std::optional<BulkCreateRPC::Request> BulkCreateBatcher::NextChunk(
+    bool flush) {
+  CHECK(chunk_items_.empty());
+  auto chunk_size = std::max<size_t>(FLAGS_bulk_create_chunk_entries, 1);
+  if (pending_.empty() || (pending_.size() < chunk_size && !flush)) {
+    return std::nullopt;
+  }
+  BulkCreateRPC::Request chunk;
+  chunk.set_uid(uid_gid_->first);
+  chunk.set_gid(uid_gid_->second);
+  // The positions in the chunk of the entries in it, by index in the stream.
+  absl::flat_hash_map<uint64_t, int> positions;
+  while (!pending_.empty() &&
+         static_cast<size_t>(chunk.entries_size()) < chunk_size) {
+    uint64_t index = ids_.size();
+    auto entry = std::move(pending_.front());
+    pending_.pop_front();
+    ids_.push_back(kInvalidInodeID);
+    auto* item = resp_.add_items();
+    if (entry.has_parent_entry()) {
+      auto parent_entry = entry.parent_entry();
+      if (parent_entry >= index) {
+        *item = Status::InvalidArgumentError(
+                    fmt::format("Entry {} refers to entry {} as its parent, "
+                                "which is not before it.",
+                                index,
+                                parent_entry))
+                    .MakeError<MkdirsResponse>();
+        continue;
+      }
+      if (auto it = positions.find(parent_entry); it != positions.end()) {
+        entry.set_parent_entry(it->second);
+      } else if (auto parent_id = ids_[parent_entry];
+                 parent_id != kInvalidInodeID) {
+        // Created by an earlier chunk.
+        entry.set_parent_id(parent_id.val);
+      } else {
+        *item = Status::ParentNotFoundError(
+                    fmt::format("Entry {} failed to be created as the parent "
+                                "of entry {}.",
+                                parent_entry,
+                                index))
+                    .MakeError<MkdirsResponse>();
+        continue;
+      }
+    }
+    positions.emplace(index, chunk.entries_size());
+    chunk_items_.push_back(resp_.items_size() - 1);
+    *chunk.add_entries() = std::move(entry);
+  }
+  if (chunk.entries_size() == 0) {
+    return std::nullopt;
+  }
+  return chunk;
+}
+
+BulkCreateRPC::Response BulkCreateBatcher::OnChunkDone(
+    const BulkCreateRPC::Response& resp) {
+  if (resp.error_code() != 0) {
+    // The txn of the chunk is aborted, so none of its entries is created.
+    for (auto item_index : chunk_items_) {
+      auto* item = resp_.mutable_items(item_index);
+      item->set_error_code(resp.error_code());
+      item->set_error_msg(resp.error_msg());
+    }
+  } else {
+    CHECK_EQ(static_cast<size_t>(resp.items_size()), chunk_items_.size());
+    for (size_t i = 0; i < chunk_items_.size(); i++) {
+      const auto& result = resp.items(static_cast<int>(i));
+      *resp_.mutable_items(chunk_items_[i]) = result;
+      if (result.error_code() == 0) {
+        ids_[resp_.first_entry() + chunk_items_[i]] = InodeID{result.id()};
+      }
+    }
+  }
+  chunk_items_.clear();
+  BulkCreateRPC::Response done;
+  done.set_first_entry(ids_.size());
+  done.Swap(&resp_);
+  return done;
+}
+
+std::optional<BulkCreateRPC::Response> BulkCreateBatcher::Finish() {
+  CHECK(pending_.empty());
+  CHECK(chunk_items_.empty());
+  if (resp_.items_size() == 0) {
+    return std::nullopt;
+  }
+  return std::move(resp_);
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,103 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <agrpc/asio_grpc.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <unifex/task.hpp>
+
+#include "common/status.h"
+#include "namenode/common/deadline.h"
+#include "namenode/namenode_ctx.h"
+#include "namenode/service/operation/op_base.h"
+#include "namenode/table/inode_id.h"
+#include "src/proto/client_namenode.grpc.pb.h"
+#include "src/proto/client_namenode.pb.h"
+
+namespace rocketfs {
+
+using BulkCreateRPC =
+    agrpc::ServerRPC<&ClientNamenodeService::AsyncService::RequestBulkCreate>;
+
+// Creates the entries of one chunk of a BulkCreate stream, as cut by
+// `BulkCreateBatcher`, in one txn. In a chunk, `parent_entry` is the index of
+// an earlier entry of the chunk itself. The parents and names under existing
+// dirs are read in one batch each, and entries under dirs of the chunk are
+// written without reads, since those dirs are new.
+class BulkCreateOp
+    : public OpBase<BulkCreateRPC,
+                    HandlerParts{.alloc = true,
+                                 .txn = true,
+                                 .dir_table = true,
+                                 .dent_view = true}> {
+ public:
+  BulkCreateOp(NameNodeCtx* namenode_ctx,
+               const BulkCreateRPC::Request& req,
+               Deadline deadline);
+  BulkCreateOp(const BulkCreateOp&) = delete;
+  BulkCreateOp(BulkCreateOp&&) = delete;
+  BulkCreateOp& operator=(const BulkCreateOp&) = delete;
+  BulkCreateOp& operator=(BulkCreateOp&&) = delete;
+  ~BulkCreateOp() = default;
+
+  unifex::task<BulkCreateRPC::Response> Run();
+
+  // See `OpBase::RunWithRetries`. The parent of the first entry, which is an
+  // existing dir, since no entry of the chunk precedes it.
+  static InodeID GetContendedDir(const BulkCreateRPC::Request& req);
+
+ private:
+  const BulkCreateRPC::Request& req_;
+};
+
+// Cuts the entries of a BulkCreate stream into chunks of up to
+// `bulk_create_chunk_entries` entries for `BulkCreateOp`, and hands out their
+// results in stream order, a resp per chunk. Chunks run one at a time, since
+// the `parent_entry` of a chunk may refer to a dir created by an earlier one,
+// which the batcher replaces with its ID. Only the ID of every entry is kept
+// for the whole stream.
+class BulkCreateBatcher {
+ public:
+  BulkCreateBatcher() = default;
+  BulkCreateBatcher(const BulkCreateBatcher&) = delete;
+  BulkCreateBatcher(BulkCreateBatcher&&) = delete;
+  BulkCreateBatcher& operator=(const BulkCreateBatcher&) = delete;
+  BulkCreateBatcher& operator=(BulkCreateBatcher&&) = delete;
+  ~BulkCreateBatcher() = default;
+
+  // Queues the entries of the next req of the stream. Fails if the req or the
+  // stream has too many, which ends the stream.
+  std::expected<void, Status> Add(const BulkCreateRPC::Request& req);
+  // Returns the next chunk to run once enough entries are queued to fill it,
+  // or if `flush`, once any are. The resp of the last chunk must have been
+  // passed to `OnChunkDone`.
+  std::optional<BulkCreateRPC::Request> NextChunk(bool flush);
+  // Returns the resp to reply with for the chunk, which also carries the
+  // results of the entries that failed before reaching it.
+  BulkCreateRPC::Response OnChunkDone(const BulkCreateRPC::Response& resp);
+  // Returns the resp to reply with for the entries that failed after the last
+  // chunk, if any. Called once no chunk is left.
+  std::optional<BulkCreateRPC::Response> Finish();
+
+ private:
+  std::optional<std::pair<uint32_t, uint32_t>> uid_gid_;
+  std::deque<BulkCreateRPC::Request::Entry> pending_;
+  // The num of entries added, including `pending_`.
+  uint64_t entries_ = 0;
+  // By index in the stream, the IDs of the entries taken off `pending_`, or
+  // `kInvalidInodeID` for those that failed or are in the running chunk.
+  std::vector<InodeID> ids_;
+  // The results not handed out yet, from `resp_.first_entry()` on.
+  BulkCreateRPC::Response resp_;
+  // The positions in `resp_` of the entries of the running chunk.
+  std::vector<int> chunk_items_;
+};
+
+}  // namespace rocketfs
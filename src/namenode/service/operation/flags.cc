@@ -7,5 +7,21 @@ namespace rocketfs {
 DEFINE_uint32(list_dir_default_limit,
               100,
               "The max num of entries to return in a single list dir op.");
+DEFINE_uint32(list_dir_stream_chunk_entries,
+              1000,
+              "The num of entries in a chunk of a ListDirStream, unless the "
+              "req sets its own.");
+DEFINE_uint32(batch_max_items,
+              1000,
+              "The max num of items in a single BatchGetInode, BatchLookup or "
+              "BulkCreate req.");
+DEFINE_uint32(bulk_create_chunk_entries,
+              1000,
+              "The max num of entries of a BulkCreate stream created in one "
+              "txn, which bounds the size of its write batch.");
+DEFINE_uint64(bulk_create_max_entries,
+              10'000'000,
+              "The max num of entries in a BulkCreate stream, which bounds the "
+              "8 bytes per entry a stream keeps to resolve `parent_entry`.");
 
 }  // namespace rocketfs
@@ -2,35 +2,61 @@
 
 #include "namenode/service/operation/get_inode_op.h"
 
+#include <absl/strings/str_split.h>
 #include <fmt/base.h>
 #include <quill/LogMacros.h>
 #include <quill/core/ThreadContextManager.h>
 #include <sys/stat.h>
 
 #include <coroutine>
+#include <cstddef>
 #include <expected>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <variant>
+#include <vector>
 
 #include <unifex/coroutine.hpp>
 
 #include "common/logger.h"
 #include "common/status.h"
+#include "namenode/common/path_prefix_cache.h"
 #include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/stat_util.h"
+#include "namenode/table/dent_view_base.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/inode_id.h"
 
 namespace rocketfs {
 
 GetInodeOp::GetInodeOp(NameNodeCtx* namenode_ctx,
-                       const GetInodeRPC::Request& req)
-    : OpBase<GetInodeRPC>(CHECK_NOTNULL(namenode_ctx)), req_(req) {
+                       const GetInodeRPC::Request& req,
+                       Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
 }
 
 unifex::task<GetInodeRPC::Response> GetInodeOp::Run() {
   InodeID id = InodeID{req_.id()};
-  auto dir = co_await handler_ctx_.GetDirTable()->Read(id);
+  if (req_.has_path()) {
+    auto resolved = co_await ResolvePath();
+    if (!resolved) {
+      co_return std::move(resolved.error());
+    }
+    if (resolved->hard_link != nullptr) {
+      GetInodeRPC::Response resp;
+      resp.set_id(resolved->id.val);
+      FillStat(*resolved->hard_link, resp.mutable_stat());
+      co_return resp;
+    }
+    id = resolved->id;
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto dir = co_await GetDirTable()->Read(id);
   if (!dir) {
     auto status = Status::SystemError(
         fmt::format("Failed to retrieve inode {}.", id.val), dir.error());
@@ -45,15 +71,137 @@ unifex::task<GetInodeRPC::Response> GetInodeOp::Run() {
   }
   GetInodeRPC::Response resp;
   resp.set_id((*dir)->id.val);
-  resp.mutable_stat()->set_id((*dir)->id.val);
-  resp.mutable_stat()->set_mode(S_IFDIR | (*dir)->acl.perm);
-  resp.mutable_stat()->set_nlink(1);
-  resp.mutable_stat()->set_uid((*dir)->acl.uid);
-  resp.mutable_stat()->set_gid((*dir)->acl.gid);
-  resp.mutable_stat()->set_atime_in_ns((*dir)->atime_in_ns);
-  resp.mutable_stat()->set_mtime_in_ns((*dir)->mtime_in_ns);
-  resp.mutable_stat()->set_ctime_in_ns((*dir)->ctime_in_ns);
+  FillStat(**dir, resp.mutable_stat());
   co_return resp;
 }
 
+unifex::task<std::expected<GetInodeOp::ResolvedPath, GetInodeRPC::Response>>
+GetInodeOp::ResolvePath() {
+  auto& cache = GetCtx()->GetPathPrefixCache();
+  // Taken before the txn starts, see `PathPrefixCache`.
+  auto version = cache.GetVersion();
+
+  std::string_view path = req_.path();
+  if (!path.starts_with('/')) {
+    auto status = Status::InvalidArgumentError(
+        fmt::format("Path {} is not absolute.", path));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return std::unexpected(status.MakeError<GetInodeRPC::Response>());
+  }
+  std::pmr::vector<std::string_view> names(GetAlloc());
+  for (std::string_view name : absl::StrSplit(path, '/', absl::SkipEmpty())) {
+    if (!CheckName(name) || name == "." || name == "..") {
+      auto status = Status::InvalidArgumentError(
+          fmt::format("Path {} has an invalid name {}.", path, name));
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return std::unexpected(status.MakeError<GetInodeRPC::Response>());
+    }
+    names.push_back(name);
+  }
+  // The first `i` names form the prefix `canonical.substr(0, ends[i])`, which
+  // is how `PathPrefixCache` keys it.
+  std::pmr::string canonical("/", GetAlloc());
+  std::pmr::vector<size_t> ends(GetAlloc());
+  ends.push_back(canonical.size());
+  for (auto name : names) {
+    if (ends.size() > 1) {
+      canonical.push_back('/');
+    }
+    canonical.append(name);
+    ends.push_back(canonical.size());
+  }
+  auto get_prefix = [&](size_t i) {
+    return std::string_view(canonical).substr(0, ends[i]);
+  };
+
+  size_t resolved = 0;
+  std::optional<PathPrefixCache::Entry> entry;
+  for (size_t i = names.size() + 1; i-- > 0;) {
+    entry = cache.Get(get_prefix(i));
+    if (entry) {
+      resolved = i;
+      break;
+    }
+  }
+  if (!entry) {
+    if (auto expired = CheckDeadline()) {
+      co_return std::unexpected(*std::move(expired));
+    }
+    auto root = co_await GetDirTable()->Read(kRootInodeID);
+    if (!root) {
+      auto status =
+          Status::SystemError("Failed to read the root dir.", root.error());
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return std::unexpected(status.MakeError<GetInodeRPC::Response>());
+    }
+    // `KVDirTable` makes up the root dir until it is first written.
+    CHECK(*root);
+    entry = PathPrefixCache::Entry{.id = kRootInodeID, .acls = {(*root)->acl}};
+    cache.Put(get_prefix(0), version, *entry);
+  }
+  CHECK_EQ(entry->acls.size(), resolved + 1);
+
+  User user{req_.uid(), req_.gid()};
+  auto check_search = [&](size_t i) -> std::expected<void, Status> {
+    auto has_permission = CheckPermission(entry->acls[i], user, S_IXOTH);
+    if (!has_permission) {
+      return std::unexpected(Status::PermissionError(
+          fmt::format("Permission denied on {} of path {}.",
+                      get_prefix(i),
+                      path),
+          has_permission.error()));
+    }
+    return {};
+  };
+  // The cached prefix itself is only searched if the walk goes on.
+  for (size_t i = 0; i < resolved; i++) {
+    if (auto searchable = check_search(i); !searchable) {
+      LOG_DEBUG(logger, "{}", searchable.error().GetMsg());
+      co_return std::unexpected(
+          searchable.error().MakeError<GetInodeRPC::Response>());
+    }
+  }
+  for (size_t i = resolved; i < names.size(); i++) {
+    if (auto searchable = check_search(i); !searchable) {
+      LOG_DEBUG(logger, "{}", searchable.error().GetMsg());
+      co_return std::unexpected(
+          searchable.error().MakeError<GetInodeRPC::Response>());
+    }
+    if (auto expired = CheckDeadline()) {
+      co_return std::unexpected(*std::move(expired));
+    }
+    auto dent = co_await GetDEntView()->Read(entry->id, names[i]);
+    if (!dent) {
+      auto status = Status::SystemError(
+          fmt::format("Failed to look up {} of path {}.",
+                      get_prefix(i + 1),
+                      path),
+          dent.error());
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return std::unexpected(status.MakeError<GetInodeRPC::Response>());
+    }
+    if (std::holds_alternative<std::monostate>(*dent)) {
+      auto status = Status::NotFoundError(
+          fmt::format("{} of path {} not found.", get_prefix(i + 1), path));
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return std::unexpected(status.MakeError<GetInodeRPC::Response>());
+    }
+    if (std::holds_alternative<const HardLinkView*>(*dent)) {
+      if (i + 1 < names.size()) {
+        auto status = Status::NotDirError(fmt::format(
+            "{} of path {} is not a dir.", get_prefix(i + 1), path));
+        LOG_DEBUG(logger, "{}", status.GetMsg());
+        co_return std::unexpected(status.MakeError<GetInodeRPC::Response>());
+      }
+      const auto* hard_link = std::get<const HardLinkView*>(*dent);
+      co_return ResolvedPath{.id = hard_link->GetID(), .hard_link = hard_link};
+    }
+    const auto& dir = *std::get<const DirView*>(*dent);
+    entry->id = dir.GetID();
+    entry->acls.push_back(dir.GetAcl());
+    cache.Put(get_prefix(i + 1), version, *entry);
+  }
+  co_return ResolvedPath{.id = entry->id, .hard_link = nullptr};
+}
+
 }  // namespace rocketfs
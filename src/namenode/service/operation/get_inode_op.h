@@ -3,10 +3,16 @@
 #pragma once
 
 #include <agrpc/asio_grpc.hpp>
+
+#include <expected>
+
 #include <unifex/task.hpp>
 
+#include "namenode/common/deadline.h"
 #include "namenode/namenode_ctx.h"
 #include "namenode/service/operation/op_base.h"
+#include "namenode/table/dent_view_base.h"
+#include "namenode/table/inode_id.h"
 #include "src/proto/client_namenode.grpc.pb.h"
 #include "src/proto/client_namenode.pb.h"
 
@@ -15,9 +21,14 @@ namespace rocketfs {
 using GetInodeRPC =
     agrpc::ServerRPC<&ClientNamenodeService::AsyncService::RequestGetInode>;
 
-class GetInodeOp : public OpBase<GetInodeRPC> {
+class GetInodeOp : public OpBase<GetInodeRPC,
+                                  HandlerParts{.alloc = true,
+                                               .dir_table = true,
+                                               .dent_view = true}> {
  public:
-  GetInodeOp(NameNodeCtx* namenode_ctx, const GetInodeRPC::Request& req);
+  GetInodeOp(NameNodeCtx* namenode_ctx,
+             const GetInodeRPC::Request& req,
+             Deadline deadline);
   GetInodeOp(const GetInodeOp&) = delete;
   GetInodeOp(GetInodeOp&&) = delete;
   GetInodeOp& operator=(const GetInodeOp&) = delete;
@@ -26,6 +37,20 @@ class GetInodeOp : public OpBase<GetInodeRPC> {
 
   unifex::task<GetInodeRPC::Response> Run();
 
+ private:
+  struct ResolvedPath {
+    InodeID id;
+    // Set if the path is a hard link rather than a dir. Owned by the
+    // `DEntViewBase` of the op.
+    const HardLinkView* hard_link;
+  };
+
+  // Resolves `req_.path` from its longest prefix in `PathPrefixCache`, one dir
+  // entry at a time, all in the txn of the op. On failure, returns the resp to
+  // reply with.
+  unifex::task<std::expected<ResolvedPath, GetInodeRPC::Response>>
+  ResolvePath();
+
  private:
   const GetInodeRPC::Request& req_;
 };
@@ -0,0 +1,65 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <absl/base/internal/endian.h>
+#include <fmt/core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+
+#include "common/status.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+// Where a paged `ListDir` resumes, handed to clients as an opaque
+// `next_cursor`: the dir, the read version of the snapshot its pages read at,
+// see `KVStoreBase::RetainSnapshot`, and the name of the last entry returned.
+// Encoded as a format byte, the big-endian ID and version, and the name.
+struct ListDirCursor {
+  static constexpr uint8_t kFormat = 1;
+  static constexpr size_t kHeaderBytes = 1 + sizeof(uint64_t) * 2;
+
+  InodeID parent_id;
+  int64_t read_version;
+  std::string_view last_name;
+
+  std::string Encode() const;
+  // The returned cursor points into `str`.
+  static std::expected<ListDirCursor, Status> Decode(std::string_view str);
+};
+
+inline std::string ListDirCursor::Encode() const {
+  std::string str(kHeaderBytes, '\0');
+  str[0] = static_cast<char>(kFormat);
+  absl::big_endian::Store64(str.data() + 1, parent_id.val);
+  absl::big_endian::Store64(str.data() + 1 + sizeof(uint64_t), read_version);
+  str.append(last_name);
+  return str;
+}
+
+inline std::expected<ListDirCursor, Status> ListDirCursor::Decode(
+    std::string_view str) {
+  if (str.size() <= kHeaderBytes ||
+      static_cast<uint8_t>(str[0]) != kFormat) {
+    return std::unexpected(Status::InvalidArgumentError(
+        fmt::format("Invalid list dir cursor of {} bytes.", str.size())));
+  }
+  ListDirCursor cursor{
+      .parent_id = InodeID{absl::big_endian::Load64(str.data() + 1)},
+      .read_version = static_cast<int64_t>(
+          absl::big_endian::Load64(str.data() + 1 + sizeof(uint64_t))),
+      .last_name = str.substr(kHeaderBytes),
+  };
+  if (auto valid_name = CheckName(cursor.last_name); !valid_name) {
+    return std::unexpected(valid_name.error());
+  }
+  return cursor;
+}
+
+}  // namespace rocketfs
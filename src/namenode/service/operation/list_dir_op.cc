@@ -2,16 +2,25 @@
 
 #include "namenode/service/operation/list_dir_op.h"
 
+#include <absl/base/internal/endian.h>
 #include <fmt/base.h>
 #include <gflags/gflags.h>
 #include <quill/LogMacros.h>
 #include <quill/core/ThreadContextManager.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <coroutine>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -20,7 +29,10 @@
 
 #include "common/logger.h"
 #include "common/status.h"
+#include "namenode/common/listing_cache.h"
 #include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/list_dir_cursor.h"
+#include "namenode/service/operation/stat_util.h"
 #include "namenode/table/dent_view_base.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/hard_link_table_base.h"
@@ -30,13 +42,77 @@ namespace rocketfs {
 
 DECLARE_uint32(list_dir_default_limit);
 
-ListDirOp::ListDirOp(NameNodeCtx* namenode_ctx, const ListDirRPC::Request& req)
-    : OpBase<ListDirRPC>(CHECK_NOTNULL(namenode_ctx)), req_(req) {
+ListDirOp::ListDirOp(NameNodeCtx* namenode_ctx,
+                     const ListDirRPC::Request& req,
+                     Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
 }
 
 unifex::task<ListDirRPC::Response> ListDirOp::Run() {
   auto parent_id = InodeID{req_.id()};
-  auto parent_dir = co_await handler_ctx_.GetDirTable()->Read(parent_id);
+  std::string_view start_after = req_.start_after();
+  std::optional<ListDirCursor> cursor;
+  if (!req_.cursor().empty()) {
+    auto decoded = ListDirCursor::Decode(req_.cursor());
+    if (!decoded) {
+      auto status = decoded.error();
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return status.MakeError<ListDirRPC::Response>();
+    }
+    cursor = *decoded;
+    if (cursor->parent_id != parent_id) {
+      auto status = Status::InvalidArgumentError(
+          fmt::format("The cursor of dir {} is used to list dir {}.",
+                      cursor->parent_id.val,
+                      parent_id.val));
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return status.MakeError<ListDirRPC::Response>();
+    }
+    start_after = cursor->last_name;
+  } else if (!start_after.empty()) {
+    auto valid_name = CheckName(start_after);
+    if (!valid_name) {
+      auto status = valid_name.error();
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return status.MakeError<ListDirRPC::Response>();
+    }
+  }
+  size_t limit = std::max<size_t>(
+      req_.limit() > 0 ? req_.limit() : FLAGS_list_dir_default_limit, 1);
+
+  auto& listing_cache = GetCtx()->GetListingCache();
+  auto cache_key = MakeCacheKey(limit);
+  auto page = listing_cache.Get(parent_id, cache_key);
+  if (page && page->read_version && !StartTxnAt(*page->read_version)) {
+    // The next page can no longer be read at the snapshot of the cursor of
+    // the page, so the page is listed afresh.
+    listing_cache.Erase(parent_id, cache_key);
+    page = nullptr;
+  }
+  if (page) {
+    if (auto denied = CheckReadPermission(parent_id, page->acl)) {
+      co_return *std::move(denied);
+    }
+    if (page->read_version) {
+      // Keeps the snapshot retained for as long as the page is served.
+      RetainSnapshot();
+    }
+    co_return *page->resp;
+  }
+  // Taken before the txn starts, see `ListingCache`.
+  auto cache_version = listing_cache.GetVersion(parent_id);
+  if (cursor && !StartTxnAt(cursor->read_version)) {
+    // The page is still correct, but may be inconsistent with the earlier
+    // ones.
+    LOG_DEBUG(logger,
+              "Snapshot {} of dir {} is no longer retained.",
+              cursor->read_version,
+              parent_id.val);
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto parent_dir = co_await GetDirTable()->Read(parent_id);
   if (!parent_dir) {
     auto status = Status::SystemError(
         fmt::format("Unable to get parent inode {}.", parent_id.val),
@@ -50,18 +126,12 @@ unifex::task<ListDirRPC::Response> ListDirOp::Run() {
     LOG_DEBUG(logger, "{}", status.GetMsg());
     co_return status.MakeError<ListDirRPC::Response>();
   }
-  auto has_permission = CheckPermission(
-      (*parent_dir)->acl, User{req_.uid(), req_.gid()}, S_IRUSR);
-  if (!has_permission) {
-    auto status = Status::PermissionError(
-        fmt::format("Permission denied on parent inode {}.", parent_id.val),
-        has_permission.error());
-    LOG_DEBUG(logger, "{}", status.GetMsg());
-    co_return status.MakeError<ListDirRPC::Response>();
+  if (auto denied = CheckReadPermission(parent_id, (*parent_dir)->acl)) {
+    co_return *std::move(denied);
   }
 
   ListDirRPC::Response resp;
-  const auto is_first_req = req_.start_after().empty();
+  const auto is_first_req = start_after.empty();
   if (is_first_req) {
     resp.mutable_self_dent()->set_id(parent_id.val);
     resp.mutable_self_dent()->set_name(".");
@@ -73,8 +143,10 @@ unifex::task<ListDirRPC::Response> ListDirOp::Run() {
       resp.mutable_parent_dent()->set_type(S_IFDIR);
     } else {
       auto grandparent_id = (*parent_dir)->parent_id;
-      auto grandparent_dir =
-          co_await handler_ctx_.GetDirTable()->Read(grandparent_id);
+      if (auto expired = CheckDeadline()) {
+        co_return *std::move(expired);
+      }
+      auto grandparent_dir = co_await GetDirTable()->Read(grandparent_id);
       if (!grandparent_dir) {
         Status status = Status::SystemError(
             fmt::format("Unable to get grandparent inode {}.",
@@ -91,10 +163,12 @@ unifex::task<ListDirRPC::Response> ListDirOp::Run() {
     }
   }
 
-  auto ents = co_await handler_ctx_.GetDEntView()->List(
-      parent_id,
-      req_.start_after(),
-      req_.limit() > 0 ? req_.limit() : FLAGS_list_dir_default_limit);
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  // One entry past the page tells whether there is more.
+  auto dent_cursor = GetDEntView()->OpenList(parent_id, start_after);
+  auto ents = co_await dent_cursor->Next(limit + 1);
   if (!ents) {
     auto status = Status::SystemError(
         fmt::format("Unable to list directory {}.", parent_id.val),
@@ -102,21 +176,128 @@ unifex::task<ListDirRPC::Response> ListDirOp::Run() {
     LOG_ERROR(logger, "{}", status.GetMsg());
     co_return status.MakeError<ListDirRPC::Response>();
   }
-  for (const auto& ent : ents.value()) {
-    if (std::holds_alternative<Dir>(ent)) {
-      auto dent = resp.add_ents();
-      dent->set_id(std::get<Dir>(ent).id.val);
-      dent->set_name(std::get<Dir>(ent).name);
-      dent->set_type(S_IFDIR);
-    } else if (std::holds_alternative<HardLink>(ent)) {
-      auto dent = resp.add_ents();
-      dent->set_id(std::get<HardLink>(ent).id.val);
-      dent->set_name(std::get<HardLink>(ent).name);
-      dent->set_type(S_IFREG);
+  // The dirs whose times are not cached in their entries, see
+  // `dent_cache_dir_times`, and so are read in one batch for the page.
+  std::pmr::vector<InodeID> uncached_ids(GetAlloc());
+  std::pmr::vector<int> uncached_ents(GetAlloc());
+  auto has_more = ents->size() > limit;
+  for (const auto& ent : ents->first(std::min(ents->size(), limit))) {
+    auto dent = resp.add_ents();
+    std::visit(
+        [dent](const auto* view) {
+          dent->set_id(view->GetID().val);
+          dent->set_name(view->GetName());
+          dent->set_type(
+              std::is_same_v<decltype(view), const DirView*> ? S_IFDIR
+                                                             : S_IFREG);
+        },
+        ent);
+    if (!req_.with_stat()) {
+      continue;
     }
+    if (std::holds_alternative<const DirView*>(ent)) {
+      const auto& dir = *std::get<const DirView*>(ent);
+      if (!FillStat(dir, dent->mutable_stat())) {
+        uncached_ids.push_back(dir.GetID());
+        uncached_ents.push_back(resp.ents_size() - 1);
+      }
+    } else {
+      FillStat(*std::get<const HardLinkView*>(ent), dent->mutable_stat());
+    }
+  }
+  resp.set_has_more(has_more);
+  std::optional<int64_t> read_version;
+  if (has_more) {
+    read_version = RetainSnapshot();
+    ListDirCursor cursor{
+        .parent_id = parent_id,
+        .read_version = *read_version,
+        .last_name = resp.ents(resp.ents_size() - 1).name(),
+    };
+    resp.set_next_cursor(cursor.Encode());
+  }
+  if (!uncached_ids.empty()) {
+    if (auto failed = co_await FillDirTimes(
+            parent_id, uncached_ids, uncached_ents, &resp)) {
+      co_return *std::move(failed);
+    }
+  }
+  if (listing_cache.Admits(parent_id)) {
+    listing_cache.Put(
+        parent_id,
+        cache_version,
+        cache_key,
+        ListingCache::Page{
+            .acl = (*parent_dir)->acl,
+            .resp = std::make_shared<const ListDirRPC::Response>(resp),
+            .read_version = read_version});
   }
-  resp.set_has_more(ents.value().size() == req_.limit());
   co_return resp;
 }
 
+std::string ListDirOp::MakeCacheKey(size_t limit) const {
+  // The position of the page is tagged, since a cursor may look like a name.
+  std::string key(1 + sizeof(uint32_t), '\0');
+  key[0] = req_.with_stat() ? 1 : 0;
+  absl::big_endian::Store32(key.data() + 1, static_cast<uint32_t>(limit));
+  if (!req_.cursor().empty()) {
+    key.push_back('c');
+    key.append(req_.cursor());
+  } else {
+    key.push_back('s');
+    key.append(req_.start_after());
+  }
+  return key;
+}
+
+std::optional<ListDirRPC::Response> ListDirOp::CheckReadPermission(
+    InodeID parent_id, const Acl& acl) {
+  auto has_permission =
+      CheckPermission(acl, User{req_.uid(), req_.gid()}, S_IROTH);
+  if (has_permission) {
+    return std::nullopt;
+  }
+  auto status = Status::PermissionError(
+      fmt::format("Permission denied on parent inode {}.", parent_id.val),
+      has_permission.error());
+  LOG_DEBUG(logger, "{}", status.GetMsg());
+  return status.MakeError<ListDirRPC::Response>();
+}
+
+unifex::task<std::optional<ListDirRPC::Response>> ListDirOp::FillDirTimes(
+    InodeID parent_id,
+    std::span<const InodeID> uncached_ids,
+    std::span<const int> uncached_ents,
+    ListDirRPC::Response* resp) {
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto dirs = co_await GetDirTable()->BatchRead(uncached_ids);
+  if (!dirs) {
+    auto status = Status::SystemError(
+        fmt::format("Failed to read {} dirs listed in directory {}.",
+                    uncached_ids.size(),
+                    parent_id.val),
+        dirs.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<ListDirRPC::Response>();
+  }
+  for (size_t i = 0; i < uncached_ids.size(); i++) {
+    const auto& dir = (*dirs)[i];
+    if (!dir) {
+      // The entry and the dir are read at one snapshot.
+      auto status = Status::SystemError(
+          fmt::format("Dir {} listed in directory {} not found.",
+                      uncached_ids[i].val,
+                      parent_id.val));
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return status.MakeError<ListDirRPC::Response>();
+    }
+    auto* stat = resp->mutable_ents(uncached_ents[i])->mutable_stat();
+    stat->set_mtime_in_ns(dir->mtime_in_ns);
+    stat->set_atime_in_ns(dir->atime_in_ns);
+  }
+  co_return std::nullopt;
+}
+
 }  // namespace rocketfs
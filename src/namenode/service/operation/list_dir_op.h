@@ -3,10 +3,19 @@
 #pragma once
 
 #include <agrpc/asio_grpc.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+
 #include <unifex/task.hpp>
 
+#include "namenode/common/deadline.h"
 #include "namenode/namenode_ctx.h"
 #include "namenode/service/operation/op_base.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
 #include "src/proto/client_namenode.grpc.pb.h"
 #include "src/proto/client_namenode.pb.h"
 
@@ -15,9 +24,15 @@ namespace rocketfs {
 using ListDirRPC =
     agrpc::ServerRPC<&ClientNamenodeService::AsyncService::RequestListDir>;
 
-class ListDirOp : public OpBase<ListDirRPC> {
+class ListDirOp
+    : public OpBase<ListDirRPC,
+                    HandlerParts{.alloc = true,
+                                 .dir_table = true,
+                                 .dent_view = true}> {
  public:
-  ListDirOp(NameNodeCtx* namenode_ctx, const ListDirRPC::Request& req);
+  ListDirOp(NameNodeCtx* namenode_ctx,
+            const ListDirRPC::Request& req,
+            Deadline deadline);
   ListDirOp(const ListDirOp&) = delete;
   ListDirOp(ListDirOp&&) = delete;
   ListDirOp& operator=(const ListDirOp&) = delete;
@@ -26,6 +41,20 @@ class ListDirOp : public OpBase<ListDirRPC> {
 
   unifex::task<ListDirRPC::Response> Run();
 
+ private:
+  // Identifies the page of the dir the req asks for in `ListingCache`.
+  std::string MakeCacheKey(size_t limit) const;
+  // Returns the resp to reply with if the user may not list the dir.
+  std::optional<ListDirRPC::Response> CheckReadPermission(InodeID parent_id,
+                                                          const Acl& acl);
+  // Fills the times of the dirs at `uncached_ents` of `resp`, which are not
+  // cached in their entries. Returns the resp to reply with on failure.
+  unifex::task<std::optional<ListDirRPC::Response>> FillDirTimes(
+      InodeID parent_id,
+      std::span<const InodeID> uncached_ids,
+      std::span<const int> uncached_ents,
+      ListDirRPC::Response* resp);
+
  private:
   const ListDirRPC::Request& req_;
 };
@@ -0,0 +1,137 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/service/operation/list_dir_stream_op.h"
+
+#include <fmt/base.h>
+#include <gflags/gflags.h>
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+#include <sys/stat.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <unifex/coroutine.hpp>
+
+#include "common/logger.h"
+#include "common/status.h"
+#include "namenode/service/handler_ctx.h"
+#include "namenode/table/dent_view_base.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/hard_link_table_base.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(list_dir_stream_chunk_entries);
+
+ListDirStreamOp::ListDirStreamOp(NameNodeCtx* namenode_ctx,
+                                 const ListDirStreamRPC::Request& req,
+                                 Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
+}
+
+unifex::task<ListDirStreamRPC::Response> ListDirStreamOp::Next() {
+  ListDirStreamRPC::Response resp;
+  if (cursor_ == nullptr) {
+    if (auto failed = co_await Open(&resp)) {
+      co_return *std::move(failed);
+    }
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  size_t limit = req_.limit() > 0 ? req_.limit()
+                                  : FLAGS_list_dir_stream_chunk_entries;
+  auto ents = co_await cursor_->Next(limit);
+  if (!ents) {
+    auto status = Status::SystemError(
+        fmt::format("Unable to list directory {}.", req_.id()), ents.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<ListDirStreamRPC::Response>();
+  }
+  resp.mutable_ents()->Reserve(ents->size());
+  for (const auto& ent : *ents) {
+    auto dent = resp.add_ents();
+    std::visit(
+        [dent](const auto* view) {
+          dent->set_id(view->GetID().val);
+          dent->set_name(view->GetName());
+          dent->set_type(
+              std::is_same_v<decltype(view), const DirView*> ? S_IFDIR
+                                                             : S_IFREG);
+        },
+        ent);
+  }
+  // A dir that ends right at a chunk boundary ends the stream with an empty
+  // chunk.
+  resp.set_has_more(ents->size() == limit);
+  co_return resp;
+}
+
+unifex::task<std::optional<ListDirStreamRPC::Response>> ListDirStreamOp::Open(
+    ListDirStreamRPC::Response* resp) {
+  CHECK_NOTNULL(resp);
+  auto parent_id = InodeID{req_.id()};
+  if (req_.with_stat()) {
+    auto status = Status::InvalidArgumentError(
+        "ListDirStream does not return stats, use ListDir instead.");
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<ListDirStreamRPC::Response>();
+  }
+  if (!req_.start_after().empty()) {
+    auto valid_name = CheckName(req_.start_after());
+    if (!valid_name) {
+      auto status = valid_name.error();
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return status.MakeError<ListDirStreamRPC::Response>();
+    }
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto parent_dir = co_await GetDirTable()->Read(parent_id);
+  if (!parent_dir) {
+    auto status = Status::SystemError(
+        fmt::format("Unable to get parent inode {}.", parent_id.val),
+        parent_dir.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<ListDirStreamRPC::Response>();
+  }
+  if (!*parent_dir) {
+    auto status = Status::ParentNotFoundError(
+        fmt::format("Parent inode {} not found.", parent_id.val));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<ListDirStreamRPC::Response>();
+  }
+  auto has_permission = CheckPermission(
+      (*parent_dir)->acl, User{req_.uid(), req_.gid()}, S_IROTH);
+  if (!has_permission) {
+    auto status = Status::PermissionError(
+        fmt::format("Permission denied on parent inode {}.", parent_id.val),
+        has_permission.error());
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<ListDirStreamRPC::Response>();
+  }
+
+  if (req_.start_after().empty()) {
+    resp->mutable_self_dent()->set_id(parent_id.val);
+    resp->mutable_self_dent()->set_name(".");
+    resp->mutable_self_dent()->set_type(S_IFDIR);
+    // The parent of the root is the root itself. The grandparent is not read,
+    // as it exists at the snapshot the parent does.
+    resp->mutable_parent_dent()->set_id((*parent_dir)->parent_id.val);
+    resp->mutable_parent_dent()->set_name("..");
+    resp->mutable_parent_dent()->set_type(S_IFDIR);
+  }
+  cursor_ = GetDEntView()->OpenList(parent_id, req_.start_after());
+  co_return std::nullopt;
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,55 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <agrpc/asio_grpc.hpp>
+
+#include <memory>
+#include <optional>
+
+#include <unifex/task.hpp>
+
+#include "namenode/common/deadline.h"
+#include "namenode/namenode_ctx.h"
+#include "namenode/service/operation/op_base.h"
+#include "namenode/table/dent_view_base.h"
+#include "src/proto/client_namenode.grpc.pb.h"
+#include "src/proto/client_namenode.pb.h"
+
+namespace rocketfs {
+
+using ListDirStreamRPC = agrpc::ServerRPC<
+    &ClientNamenodeService::AsyncService::RequestListDirStream>;
+
+// Lists a dir chunk by chunk through one `DEntCursorBase`, i.e., one iterator
+// at the snapshot of one txn, for as long as the stream lasts.
+class ListDirStreamOp
+    : public OpBase<ListDirStreamRPC,
+                    HandlerParts{.dir_table = true, .dent_view = true}> {
+ public:
+  ListDirStreamOp(NameNodeCtx* namenode_ctx,
+                  const ListDirStreamRPC::Request& req,
+                  Deadline deadline);
+  ListDirStreamOp(const ListDirStreamOp&) = delete;
+  ListDirStreamOp(ListDirStreamOp&&) = delete;
+  ListDirStreamOp& operator=(const ListDirStreamOp&) = delete;
+  ListDirStreamOp& operator=(ListDirStreamOp&&) = delete;
+  ~ListDirStreamOp() = default;
+
+  // Returns the next chunk to write. The stream ends with the first chunk
+  // without `has_more`, which every error is.
+  unifex::task<ListDirStreamRPC::Response> Next();
+
+ private:
+  // Checks the req and the parent dir, fills the dents of the first chunk
+  // into `resp` and opens `cursor_`. On failure, returns the resp to reply
+  // with instead.
+  unifex::task<std::optional<ListDirStreamRPC::Response>> Open(
+      ListDirStreamRPC::Response* resp);
+
+ private:
+  const ListDirStreamRPC::Request& req_;
+  std::unique_ptr<DEntCursorBase> cursor_;
+};
+
+}  // namespace rocketfs
@@ -5,7 +5,6 @@
 #include <fmt/base.h>
 #include <quill/LogMacros.h>
 #include <quill/core/ThreadContextManager.h>
-#include <sys/stat.h>
 
 #include <coroutine>
 #include <expected>
@@ -19,6 +18,7 @@
 #include "common/logger.h"
 #include "common/status.h"
 #include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/stat_util.h"
 #include "namenode/table/dent_view_base.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/hard_link_table_base.h"
@@ -26,13 +26,24 @@
 
 namespace rocketfs {
 
-LookupOp::LookupOp(NameNodeCtx* namenode_ctx, const LookupRPC::Request& req)
-    : OpBase<LookupRPC>(CHECK_NOTNULL(namenode_ctx)), req_(req) {
+LookupOp::LookupOp(NameNodeCtx* namenode_ctx,
+                   const LookupRPC::Request& req,
+                   Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
 }
 
 unifex::task<LookupRPC::Response> LookupOp::Run() {
   auto parent_id = InodeID{req_.parent_id()};
-  auto dent = co_await handler_ctx_.GetDEntView()->Read(parent_id, req_.name());
+  auto valid_name = CheckName(req_.name());
+  if (!valid_name) {
+    auto status = valid_name.error();
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<LookupRPC::Response>();
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto dent = co_await GetDEntView()->Read(parent_id, req_.name());
   if (!dent) {
     auto status = Status::SystemError(
         fmt::format("Failed to look up with parent ID {} and name {}.",
@@ -50,28 +61,38 @@ unifex::task<LookupRPC::Response> LookupOp::Run() {
     co_return status.MakeError<LookupRPC::Response>();
   }
 
-  if (std::holds_alternative<Dir>(*dent)) {
-    const auto& dir = std::get<Dir>(*dent);
-    LookupRPC::Response resp;
-    resp.set_id(dir.id.val);
-    resp.mutable_stat()->set_id(dir.id.val);
-    resp.mutable_stat()->set_mode(S_IFDIR | dir.acl.perm);
-    resp.mutable_stat()->set_nlink(1);
-    resp.mutable_stat()->set_uid(dir.acl.uid);
-    resp.mutable_stat()->set_gid(dir.acl.gid);
-    resp.mutable_stat()->set_atime_in_ns(dir.atime_in_ns);
-    resp.mutable_stat()->set_mtime_in_ns(dir.mtime_in_ns);
-    resp.mutable_stat()->set_ctime_in_ns(dir.ctime_in_ns);
+  LookupRPC::Response resp;
+  if (std::holds_alternative<const HardLinkView*>(*dent)) {
+    const auto& hard_link = *std::get<const HardLinkView*>(*dent);
+    resp.set_id(hard_link.GetID().val);
+    FillStat(hard_link, resp.mutable_stat());
     co_return resp;
   }
-
-  CHECK(std::holds_alternative<HardLink>(*dent));
-  const auto& hard_link = std::get<HardLink>(*dent);
-  LookupRPC::Response resp;
-  resp.set_id(hard_link.id.val);
-  resp.mutable_stat()->set_id(hard_link.id.val);
-  resp.mutable_stat()->set_mode(S_IFREG);
-  resp.mutable_stat()->set_nlink(1);
+  const auto& dir = *std::get<const DirView*>(*dent);
+  resp.set_id(dir.GetID().val);
+  if (FillStat(dir, resp.mutable_stat())) {
+    co_return resp;
+  }
+  // The times are not cached in the dir entry, see `dent_cache_dir_times`.
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto full_dir = co_await GetDirTable()->Read(dir.GetID());
+  if (!full_dir) {
+    auto status =
+        Status::SystemError(fmt::format("Failed to read dir {}.", resp.id()),
+                            full_dir.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<LookupRPC::Response>();
+  }
+  if (!*full_dir) {
+    auto status =
+        Status::NotFoundError(fmt::format("Dir {} not found.", resp.id()));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<LookupRPC::Response>();
+  }
+  resp.mutable_stat()->set_mtime_in_ns((*full_dir)->mtime_in_ns);
+  resp.mutable_stat()->set_atime_in_ns((*full_dir)->atime_in_ns);
   co_return resp;
 }
 
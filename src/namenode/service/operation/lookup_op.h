@@ -5,6 +5,7 @@
 #include <agrpc/asio_grpc.hpp>
 #include <unifex/task.hpp>
 
+#include "namenode/common/deadline.h"
 #include "namenode/namenode_ctx.h"
 #include "namenode/service/operation/op_base.h"
 #include "src/proto/client_namenode.grpc.pb.h"
@@ -15,9 +16,13 @@ namespace rocketfs {
 using LookupRPC =
     agrpc::ServerRPC<&ClientNamenodeService::AsyncService::RequestLookup>;
 
-class LookupOp : public OpBase<LookupRPC> {
+class LookupOp
+    : public OpBase<LookupRPC,
+                    HandlerParts{.dir_table = true, .dent_view = true}> {
  public:
-  LookupOp(NameNodeCtx* namenode_ctx, const LookupRPC::Request& req);
+  LookupOp(NameNodeCtx* namenode_ctx,
+           const LookupRPC::Request& req,
+           Deadline deadline);
   LookupOp(const LookupOp&) = delete;
   LookupOp(LookupOp&&) = delete;
   LookupOp& operator=(const LookupOp&) = delete;
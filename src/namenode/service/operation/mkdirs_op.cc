@@ -2,16 +2,22 @@
 
 #include "namenode/service/operation/mkdirs_op.h"
 
+#include <absl/strings/str_split.h>
+#include <fmt/core.h>
 #include <quill/LogMacros.h>
 #include <quill/core/ThreadContextManager.h>
 #include <sys/stat.h>
 
 #include <coroutine>
+#include <cstddef>
 #include <expected>
 #include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <variant>
+#include <vector>
 
 #include <unifex/coroutine.hpp>
 
@@ -19,19 +25,35 @@
 #include "common/status.h"
 #include "common/time_util.h"
 #include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/stat_util.h"
+#include "namenode/table/dent_view_base.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/inode_id.h"
 #include "namenode/table/kv/kv_store_base.h"
 
 namespace rocketfs {
 
-MkdirsOp::MkdirsOp(NameNodeCtx* namenode_ctx, const MkdirsRPC::Request& req)
-    : handler_ctx_(CHECK_NOTNULL(namenode_ctx)), req_(req) {
+MkdirsOp::MkdirsOp(NameNodeCtx* namenode_ctx,
+                   const MkdirsRPC::Request& req,
+                   Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
 }
 
 unifex::task<MkdirsRPC::Response> MkdirsOp::Run() {
+  if (req_.parents()) {
+    co_return co_await RunWithParents();
+  }
   auto parent_id = InodeID{req_.parent_id()};
-  auto parent_dir = co_await handler_ctx_.GetDirTable()->Read(parent_id);
+  auto valid_name = CheckName(req_.name());
+  if (!valid_name) {
+    auto status = valid_name.error();
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto parent_dir = co_await GetDirTable()->Read(parent_id);
   if (!parent_dir) {
     LOG_ERROR(logger,
               "Unable to retrieve parent directory for inode {}: {}.",
@@ -52,35 +74,251 @@ unifex::task<MkdirsRPC::Response> MkdirsOp::Run() {
     resp.set_error_code(static_cast<int>(StatusCode::kPermissionError));
     co_return resp;
   }
+  // Reading the name also puts it in the read set, so a racing create of the
+  // same name conflicts instead of being overwritten.
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto dent = co_await GetDEntView()->Read(parent_id, req_.name());
+  if (!dent) {
+    auto status = Status::SystemError(
+        fmt::format("Failed to look up {} under dir {}.",
+                    req_.name(),
+                    parent_id.val),
+        dent.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
+  if (!std::holds_alternative<std::monostate>(*dent)) {
+    auto status = Status::AlreadyExistsError(fmt::format(
+        "{} under dir {} already exists.", req_.name(), parent_id.val));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
 
-  auto id = handler_ctx_.GetCtx()->GetInodeIDGen().Next();
+  auto id = GetCtx()->GetInodeIDGen().Next();
+  if (!id) {
+    LOG_ERROR(
+        logger, "Unable to allocate an inode ID: {}.", id.error().GetMsg());
+    MkdirsRPC::Response resp;
+    resp.set_error_code(static_cast<int>(StatusCode::kSystemError));
+    co_return resp;
+  }
   Acl acl{.uid = req_.uid(), .gid = req_.gid(), .perm = req_.mode() & ALLPERMS};
   if ((*parent_dir)->acl.perm & S_ISGID) {
     acl.gid = (*parent_dir)->acl.gid;
     acl.perm |= S_ISGID;
   }
-  auto now_ns = handler_ctx_.GetCtx()->GetTimeUtil()->NowNs();
+  auto now_ns = GetCtx()->GetTimeUtil()->NowNs();
   Dir dir{.parent_id = InodeID{req_.parent_id()},
-          .name = std::pmr::string(req_.name(), handler_ctx_.GetAlloc()),
-          .id = id,
+          .name = std::pmr::string(req_.name(), GetAlloc()),
+          .id = *id,
           .acl = acl,
           .ctime_in_ns = now_ns,
           .mtime_in_ns = now_ns,
           .atime_in_ns = now_ns};
-  handler_ctx_.GetDirTable()->Write(std::nullopt, dir);
-  co_await handler_ctx_.GetCtx()->GetKVStore()->CommitTxn(
-      handler_ctx_.GetTxn());
+  GetDirTable()->Write(std::nullopt, dir);
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  if (auto failed = co_await Commit(parent_id)) {
+    co_return *std::move(failed);
+  }
   MkdirsRPC::Response resp;
   resp.set_id(dir.id.val);
-  resp.mutable_stat()->set_id(dir.id.val);
-  resp.mutable_stat()->set_mode(S_IFDIR | dir.acl.perm);
-  resp.mutable_stat()->set_nlink(1);
-  resp.mutable_stat()->set_uid(dir.acl.uid);
-  resp.mutable_stat()->set_gid(dir.acl.gid);
-  resp.mutable_stat()->set_atime_in_ns(dir.atime_in_ns);
-  resp.mutable_stat()->set_mtime_in_ns(dir.mtime_in_ns);
-  resp.mutable_stat()->set_ctime_in_ns(dir.ctime_in_ns);
+  FillStat(dir, resp.mutable_stat());
   co_return resp;
 }
 
+InodeID MkdirsOp::GetContendedDir(const MkdirsRPC::Request& req) {
+  return InodeID{req.parent_id()};
+}
+
+unifex::task<MkdirsRPC::Response> MkdirsOp::RunWithParents() {
+  std::string_view path = req_.name();
+  std::pmr::vector<std::string_view> names(GetAlloc());
+  for (std::string_view name : absl::StrSplit(path, '/', absl::SkipEmpty())) {
+    if (!CheckName(name) || name == "." || name == "..") {
+      auto status = Status::InvalidArgumentError(
+          fmt::format("Path {} has an invalid name {}.", path, name));
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return status.MakeError<MkdirsRPC::Response>();
+    }
+    names.push_back(name);
+  }
+  if (names.empty()) {
+    auto status =
+        Status::InvalidArgumentError(fmt::format("Path {} is empty.", path));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
+
+  auto parent_id = InodeID{req_.parent_id()};
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  auto parent_dir = co_await GetDirTable()->Read(parent_id);
+  if (!parent_dir) {
+    auto status = Status::SystemError(
+        fmt::format("Unable to get parent inode {}.", parent_id.val),
+        parent_dir.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
+  if (!*parent_dir) {
+    auto status = Status::ParentNotFoundError(
+        fmt::format("Parent inode {} not found.", parent_id.val));
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
+
+  // Walks down the dirs that already exist. `dir` ends up at the deepest one.
+  User user{req_.uid(), req_.gid()};
+  auto dir = **std::move(parent_dir);
+  auto times_cached = true;
+  size_t existing = 0;
+  for (; existing < names.size(); existing++) {
+    auto has_permission = CheckPermission(dir.acl, user, S_IXOTH);
+    if (!has_permission) {
+      auto status = Status::PermissionError(
+          fmt::format("Permission denied on dir {} of path {}.",
+                      dir.id.val,
+                      path),
+          has_permission.error());
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return status.MakeError<MkdirsRPC::Response>();
+    }
+    if (auto expired = CheckDeadline()) {
+      co_return *std::move(expired);
+    }
+    auto dent = co_await GetDEntView()->Read(dir.id, names[existing]);
+    if (!dent) {
+      auto status = Status::SystemError(
+          fmt::format("Failed to look up {} under dir {} of path {}.",
+                      names[existing],
+                      dir.id.val,
+                      path),
+          dent.error());
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return status.MakeError<MkdirsRPC::Response>();
+    }
+    if (std::holds_alternative<std::monostate>(*dent)) {
+      break;
+    }
+    if (std::holds_alternative<const HardLinkView*>(*dent)) {
+      auto msg = fmt::format("{} under dir {} of path {} is not a dir.",
+                             names[existing],
+                             dir.id.val,
+                             path);
+      auto status = existing + 1 < names.size()
+                        ? Status::NotDirError(msg)
+                        : Status::AlreadyExistsError(msg);
+      LOG_DEBUG(logger, "{}", status.GetMsg());
+      co_return status.MakeError<MkdirsRPC::Response>();
+    }
+    const auto& dir_view = *std::get<const DirView*>(*dent);
+    dir = dir_view.ToDir(GetAlloc());
+    times_cached = dir_view.GetMTimeInNs() && dir_view.GetATimeInNs();
+  }
+
+  if (existing == names.size()) {
+    // The whole path exists, which is not an error, so retries are
+    // idempotent. Nothing was written, so there is nothing to commit.
+    if (!times_cached) {
+      if (auto expired = CheckDeadline()) {
+        co_return *std::move(expired);
+      }
+      auto full_dir = co_await GetDirTable()->Read(dir.id);
+      if (!full_dir) {
+        auto status = Status::SystemError(
+            fmt::format("Unable to get dir {} of path {}.", dir.id.val, path),
+            full_dir.error());
+        LOG_ERROR(logger, "{}", status.GetMsg());
+        co_return status.MakeError<MkdirsRPC::Response>();
+      }
+      // The entry and the dir are read at one snapshot.
+      CHECK(*full_dir);
+      dir = **std::move(full_dir);
+    }
+    MkdirsRPC::Response resp;
+    resp.set_id(dir.id.val);
+    FillStat(dir, resp.mutable_stat());
+    co_return resp;
+  }
+
+  auto has_permission = CheckPermission(dir.acl, user, S_IWOTH);
+  if (!has_permission) {
+    auto status = Status::PermissionError(
+        fmt::format("Permission denied on dir {} of path {}.",
+                    dir.id.val,
+                    path),
+        has_permission.error());
+    LOG_DEBUG(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
+  // The dirs below are new, so the rest of the path is created without
+  // reading anything.
+  auto created_under = dir.id;
+  auto now_ns = GetCtx()->GetTimeUtil()->NowNs();
+  for (size_t i = existing; i < names.size(); i++) {
+    auto id = GetCtx()->GetInodeIDGen().Next();
+    if (!id) {
+      auto status =
+          Status::SystemError("Unable to allocate an inode ID.", id.error());
+      LOG_ERROR(logger, "{}", status.GetMsg());
+      co_return status.MakeError<MkdirsRPC::Response>();
+    }
+    Acl acl{
+        .uid = req_.uid(), .gid = req_.gid(), .perm = req_.mode() & ALLPERMS};
+    if (i + 1 < names.size()) {
+      // Like `mkdir -p`, the user may always create the rest of the path in
+      // the dirs in between, whatever `mode` is.
+      acl.perm |= S_IWUSR | S_IXUSR;
+    }
+    if (dir.acl.perm & S_ISGID) {
+      acl.gid = dir.acl.gid;
+      acl.perm |= S_ISGID;
+    }
+    Dir child{.parent_id = dir.id,
+              .name = std::pmr::string(names[i], GetAlloc()),
+              .id = *id,
+              .acl = acl,
+              .ctime_in_ns = now_ns,
+              .mtime_in_ns = now_ns,
+              .atime_in_ns = now_ns};
+    GetDirTable()->Write(std::nullopt, child);
+    dir = std::move(child);
+  }
+  if (auto expired = CheckDeadline()) {
+    co_return *std::move(expired);
+  }
+  if (auto failed = co_await Commit(created_under)) {
+    co_return *std::move(failed);
+  }
+  MkdirsRPC::Response resp;
+  resp.set_id(dir.id.val);
+  FillStat(dir, resp.mutable_stat());
+  co_return resp;
+}
+
+unifex::task<std::optional<MkdirsRPC::Response>> MkdirsOp::Commit(
+    InodeID parent_id) {
+  auto committed = co_await GetCtx()->GetKVStore()->CommitTxn(GetTxn());
+  if (!committed && committed.error().GetCode() == StatusCode::kConflictError) {
+    // Retried by `RunWithRetries`.
+    co_return committed.error().MakeError<MkdirsRPC::Response>();
+  }
+  if (!committed) {
+    auto status = Status::SystemError(
+        fmt::format("Failed to create dir {} under parent {}.",
+                    req_.name(),
+                    parent_id.val),
+        committed.error());
+    LOG_ERROR(logger, "{}", status.GetMsg());
+    co_return status.MakeError<MkdirsRPC::Response>();
+  }
+  GetCtx()->GetListingCache().Invalidate(parent_id);
+  co_return std::nullopt;
+}
+
 }  // namespace rocketfs
@@ -3,10 +3,15 @@
 #pragma once
 
 #include <agrpc/asio_grpc.hpp>
+
+#include <optional>
+
 #include <unifex/task.hpp>
 
+#include "namenode/common/deadline.h"
 #include "namenode/namenode_ctx.h"
-#include "namenode/service/handler_ctx.h"
+#include "namenode/service/operation/op_base.h"
+#include "namenode/table/inode_id.h"
 #include "src/proto/client_namenode.grpc.pb.h"
 #include "src/proto/client_namenode.pb.h"
 
@@ -15,9 +20,17 @@ namespace rocketfs {
 using MkdirsRPC =
     agrpc::ServerRPC<&ClientNamenodeService::AsyncService::RequestMkdirs>;
 
-class MkdirsOp {
+class MkdirsOp
+    : public OpBase<
+          MkdirsRPC,
+          HandlerParts{.alloc = true,
+                       .txn = true,
+                       .dir_table = true,
+                       .dent_view = true}> {
  public:
-  MkdirsOp(NameNodeCtx* namenode_ctx, const MkdirsRPC::Request& req);
+  MkdirsOp(NameNodeCtx* namenode_ctx,
+           const MkdirsRPC::Request& req,
+           Deadline deadline);
   MkdirsOp(const MkdirsOp&) = delete;
   MkdirsOp(MkdirsOp&&) = delete;
   MkdirsOp& operator=(const MkdirsOp&) = delete;
@@ -26,8 +39,18 @@ class MkdirsOp {
 
   unifex::task<MkdirsRPC::Response> Run();
 
+  // See `OpBase::RunWithRetries`.
+  static InodeID GetContendedDir(const MkdirsRPC::Request& req);
+
+ private:
+  // Creates the missing dirs of the path `name` in one txn, see
+  // `MkdirsRequest.parents`.
+  unifex::task<MkdirsRPC::Response> RunWithParents();
+  // Commits the txn, which created dirs under `parent_id`. Returns the resp to
+  // reply with on failure.
+  unifex::task<std::optional<MkdirsRPC::Response>> Commit(InodeID parent_id);
+
  private:
-  HandlerCtx handler_ctx_;
   const MkdirsRPC::Request& req_;
 };
 
@@ -2,31 +2,193 @@
 
 #pragma once
 
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 
+#include <unifex/task.hpp>
+
+#include "common/logger.h"
 #include "common/status.h"
+#include "namenode/common/deadline.h"
+#include "namenode/common/req_arena.h"
+#include "namenode/common/req_scoped_alloc.h"
 #include "namenode/namenode_ctx.h"
+#include "namenode/service/conflict_retrier.h"
 #include "namenode/service/handler_ctx.h"
+#include "namenode/table/dent_view_base.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/kv/kv_store_base.h"
 
 namespace rocketfs {
 
-template <typename RPC>
+// `kParts` declares the components of `HandlerCtx` the op uses, e.g.,
+// `OpBase<GetInodeRPC, HandlerParts{.dir_table = true}>`.
+template <typename RPC, HandlerParts kParts>
 class OpBase {
  public:
-  explicit OpBase(NameNodeCtx* namenode_ctx);
+  static constexpr HandlerParts kHandlerParts = kParts;
+
+  OpBase(NameNodeCtx* namenode_ctx, Deadline deadline);
   OpBase(const OpBase&) = delete;
   OpBase(OpBase&&) = delete;
   OpBase& operator=(const OpBase&) = delete;
   OpBase& operator=(OpBase&&) = delete;
   ~OpBase() = default;
 
+  // Runs ops of `Op` on `req` until one does not fail with `ConflictError` or
+  // `GetConflictRetrier` gives up, each on its own `HandlerCtx` and so on a
+  // fresh txn. `sleep(backoff_ns)` returns a task that waits out the backoff
+  // before a retry, and resumes on the thread the op runs on. Aging is scoped
+  // to the dir `Op::GetContendedDir(req)` returns.
+  template <typename Op, typename Sleep>
+  static unifex::task<typename RPC::Response> RunWithRetries(
+      NameNodeCtx* namenode_ctx,
+      const typename RPC::Request& req,
+      Deadline deadline,
+      Sleep sleep);
+
  protected:
+  // Shared by all ops of `RPC`.
+  static ArenaSizer* GetArenaSizer();
+  static ConflictRetrier* GetConflictRetrier();
+
+  // Returns the resp to reply with if the deadline of the req has expired, in
+  // which case the op must stop. Called before every step of an op.
+  std::optional<typename RPC::Response> CheckDeadline();
+
+  NameNodeCtx* GetCtx();
+  ReqScopedAlloc GetAlloc()
+    requires(kParts.alloc);
+  std::unique_ptr<TxnBase> GetTxn()
+    requires(kParts.txn);
+  DirTableBase* GetDirTable()
+    requires(kParts.dir_table);
+  DEntViewBase* GetDEntView()
+    requires(kParts.dent_view);
+  // See `HandlerCtx::StartTxnAt` and `HandlerCtx::RetainSnapshot`.
+  bool StartTxnAt(int64_t read_version)
+    requires(kParts.NeedsKV());
+  int64_t RetainSnapshot()
+    requires(kParts.NeedsKV());
+
+ private:
   HandlerCtx handler_ctx_;
 };
 
-template <typename RPC>
-OpBase<RPC>::OpBase(NameNodeCtx* namenode_ctx)
-    : handler_ctx_(CHECK_NOTNULL(namenode_ctx)) {
+template <typename RPC, HandlerParts kParts>
+OpBase<RPC, kParts>::OpBase(NameNodeCtx* namenode_ctx, Deadline deadline)
+    : handler_ctx_(CHECK_NOTNULL(namenode_ctx), deadline, GetArenaSizer()) {
+}
+
+template <typename RPC, HandlerParts kParts>
+ArenaSizer* OpBase<RPC, kParts>::GetArenaSizer() {
+  static ArenaSizer arena_sizer(RPC::Request::descriptor()->name());
+  return &arena_sizer;
+}
+
+template <typename RPC, HandlerParts kParts>
+ConflictRetrier* OpBase<RPC, kParts>::GetConflictRetrier() {
+  static ConflictRetrier conflict_retrier(RPC::Request::descriptor()->name());
+  return &conflict_retrier;
+}
+
+template <typename RPC, HandlerParts kParts>
+template <typename Op, typename Sleep>
+unifex::task<typename RPC::Response> OpBase<RPC, kParts>::RunWithRetries(
+    NameNodeCtx* namenode_ctx,
+    const typename RPC::Request& req,
+    Deadline deadline,
+    Sleep sleep) {
+  auto* retrier = GetConflictRetrier();
+  auto dir = Op::GetContendedDir(req);
+  // Polls rather than waits to be woken, so that a waiter gives up at its
+  // deadline and resumes through `sleep` rather than inline on the thread of
+  // the aged op that finishes. An expired op fails its first step.
+  while (retrier->HasAgedOps(dir) && !deadline.IsExpired()) {
+    co_await sleep(retrier->GetAgedPollNs());
+  }
+  std::optional<ConflictRetrier::Aged> aged;
+  for (uint32_t retries = 0;; retries++) {
+    auto resp = co_await Op(namenode_ctx, req, deadline).Run();
+    if (static_cast<StatusCode>(resp.error_code()) !=
+        StatusCode::kConflictError) {
+      co_return resp;
+    }
+    auto backoff_ns = retrier->OnConflict(retries);
+    if (!backoff_ns) {
+      LOG_WARNING(logger,
+                  "Gave up on req {} after {} conflicts.",
+                  req.ShortDebugString(),
+                  retries + 1);
+      co_return resp;
+    }
+    if (!aged && retrier->IsAged(retries + 1)) {
+      aged.emplace(dir);
+    }
+    co_await sleep(*backoff_ns);
+  }
+}
+
+template <typename RPC, HandlerParts kParts>
+std::optional<typename RPC::Response> OpBase<RPC, kParts>::CheckDeadline() {
+  auto alive = handler_ctx_.GetDeadline().Check();
+  if (alive) {
+    return std::nullopt;
+  }
+  LOG_DEBUG(logger, "{}", alive.error().GetMsg());
+  return alive.error().template MakeError<typename RPC::Response>();
+}
+
+template <typename RPC, HandlerParts kParts>
+NameNodeCtx* OpBase<RPC, kParts>::GetCtx() {
+  return handler_ctx_.GetCtx();
+}
+
+template <typename RPC, HandlerParts kParts>
+ReqScopedAlloc OpBase<RPC, kParts>::GetAlloc()
+  requires(kParts.alloc)
+{
+  return handler_ctx_.GetAlloc();
+}
+
+template <typename RPC, HandlerParts kParts>
+std::unique_ptr<TxnBase> OpBase<RPC, kParts>::GetTxn()
+  requires(kParts.txn)
+{
+  return handler_ctx_.GetTxn();
+}
+
+template <typename RPC, HandlerParts kParts>
+DirTableBase* OpBase<RPC, kParts>::GetDirTable()
+  requires(kParts.dir_table)
+{
+  return handler_ctx_.GetDirTable();
+}
+
+template <typename RPC, HandlerParts kParts>
+DEntViewBase* OpBase<RPC, kParts>::GetDEntView()
+  requires(kParts.dent_view)
+{
+  return handler_ctx_.GetDEntView();
+}
+
+template <typename RPC, HandlerParts kParts>
+bool OpBase<RPC, kParts>::StartTxnAt(int64_t read_version)
+  requires(kParts.NeedsKV())
+{
+  return handler_ctx_.StartTxnAt(read_version);
+}
+
+template <typename RPC, HandlerParts kParts>
+int64_t OpBase<RPC, kParts>::RetainSnapshot()
+  requires(kParts.NeedsKV())
+{
+  return handler_ctx_.RetainSnapshot();
 }
 
 }  // namespace rocketfs
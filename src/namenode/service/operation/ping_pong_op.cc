@@ -6,11 +6,14 @@
 
 #include <unifex/coroutine.hpp>
 
+#include "common/logger.h"
+
 namespace rocketfs {
 
 PingPongOp::PingPongOp(NameNodeCtx* namenode_ctx,
-                       const PingPongRPC::Request& req)
-    : namenode_ctx_(namenode_ctx), req_(req) {
+                       const PingPongRPC::Request& req,
+                       Deadline deadline)
+    : OpBase(CHECK_NOTNULL(namenode_ctx), deadline), req_(req) {
 }
 
 unifex::task<PingPongRPC::Response> PingPongOp::Run() {
@@ -5,7 +5,9 @@
 #include <agrpc/asio_grpc.hpp>
 #include <unifex/task.hpp>
 
+#include "namenode/common/deadline.h"
 #include "namenode/namenode_ctx.h"
+#include "namenode/service/operation/op_base.h"
 #include "src/proto/client_namenode.grpc.pb.h"
 #include "src/proto/client_namenode.pb.h"
 
@@ -14,14 +16,22 @@ namespace rocketfs {
 using PingPongRPC =
     agrpc::ServerRPC<&ClientNamenodeService::AsyncService::RequestPingPong>;
 
-class PingPongOp {
+// Uses no component of `HandlerCtx`, so it costs no more than the RPC itself.
+class PingPongOp : public OpBase<PingPongRPC, HandlerParts{}> {
  public:
-  PingPongOp(NameNodeCtx* namenode_ctx, const PingPongRPC::Request& req);
+  // Never stops early, since it does no work.
+  PingPongOp(NameNodeCtx* namenode_ctx,
+             const PingPongRPC::Request& req,
+             Deadline deadline);
+  PingPongOp(const PingPongOp&) = delete;
+  PingPongOp(PingPongOp&&) = delete;
+  PingPongOp& operator=(const PingPongOp&) = delete;
+  PingPongOp& operator=(PingPongOp&&) = delete;
+  ~PingPongOp() = default;
 
   unifex::task<PingPongRPC::Response> Run();
 
  private:
-  NameNodeCtx* namenode_ctx_;
   const PingPongRPC::Request& req_;
 };
 
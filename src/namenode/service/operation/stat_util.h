@@ -0,0 +1,56 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <sys/stat.h>
+
+#include <optional>
+
+#include "common/logger.h"
+#include "namenode/table/dent_view_base.h"
+#include "namenode/table/dir_table_base.h"
+#include "src/proto/client_namenode.pb.h"
+
+namespace rocketfs {
+
+inline void FillStat(const Dir& dir, Stat* stat) {
+  CHECK_NOTNULL(stat);
+  stat->set_id(dir.id.val);
+  stat->set_mode(S_IFDIR | dir.acl.perm);
+  stat->set_nlink(1);
+  stat->set_uid(dir.acl.uid);
+  stat->set_gid(dir.acl.gid);
+  stat->set_atime_in_ns(dir.atime_in_ns);
+  stat->set_mtime_in_ns(dir.mtime_in_ns);
+  stat->set_ctime_in_ns(dir.ctime_in_ns);
+}
+
+// Fills all but the times that are not cached in `dir`, see
+// `dent_cache_dir_times`, and returns whether it filled the times too.
+inline bool FillStat(const DirView& dir, Stat* stat) {
+  CHECK_NOTNULL(stat);
+  auto acl = dir.GetAcl();
+  stat->set_id(dir.GetID().val);
+  stat->set_mode(S_IFDIR | acl.perm);
+  stat->set_nlink(1);
+  stat->set_uid(acl.uid);
+  stat->set_gid(acl.gid);
+  stat->set_ctime_in_ns(dir.GetCTimeInNs());
+  auto mtime_in_ns = dir.GetMTimeInNs();
+  auto atime_in_ns = dir.GetATimeInNs();
+  if (!mtime_in_ns || !atime_in_ns) {
+    return false;
+  }
+  stat->set_mtime_in_ns(*mtime_in_ns);
+  stat->set_atime_in_ns(*atime_in_ns);
+  return true;
+}
+
+inline void FillStat(const HardLinkView& hard_link, Stat* stat) {
+  CHECK_NOTNULL(stat);
+  stat->set_id(hard_link.GetID().val);
+  stat->set_mode(S_IFREG);
+  stat->set_nlink(1);
+}
+
+}  // namespace rocketfs
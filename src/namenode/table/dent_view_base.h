@@ -2,17 +2,110 @@
 
 #pragma once
 
+#include <cstdint>
 #include <expected>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
+#include <vector>
+
+#include <unifex/task.hpp>
 
 #include "common/status.h"
+#include "namenode/common/req_scoped_alloc.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/hard_link_table_base.h"
 #include "namenode/table/inode_id.h"
 
 namespace rocketfs {
 
+// `DirView` and `HardLinkView` are non-owning views over a dir entry as it is
+// stored, see `KVDirView` and `KVHardLinkView`. Fields are decoded on access
+// and `GetName` points into the stored value, so callers pay only for the
+// fields they read.
+class DirView {
+ public:
+  virtual ~DirView() = default;
+
+  virtual InodeID GetParentID() const = 0;
+  virtual std::string_view GetName() const = 0;
+  virtual InodeID GetID() const = 0;
+  virtual Acl GetAcl() const = 0;
+  virtual int64_t GetCTimeInNs() const = 0;
+  // Return std::nullopt if the times are not cached in the entry, in which
+  // case they have to be read from the dir table.
+  virtual std::optional<int64_t> GetMTimeInNs() const = 0;
+  virtual std::optional<int64_t> GetATimeInNs() const = 0;
+
+  Dir ToDir(ReqScopedAlloc alloc) const;
+
+ protected:
+  // Copyable only by implementations, so that a view is never sliced.
+  DirView() = default;
+  DirView(const DirView&) = default;
+  DirView& operator=(const DirView&) = default;
+};
+
+class HardLinkView {
+ public:
+  virtual ~HardLinkView() = default;
+
+  virtual InodeID GetParentID() const = 0;
+  virtual std::string_view GetName() const = 0;
+  virtual InodeID GetID() const = 0;
+
+  HardLink ToHardLink(ReqScopedAlloc alloc) const;
+
+ protected:
+  HardLinkView() = default;
+  HardLinkView(const HardLinkView&) = default;
+  HardLinkView& operator=(const HardLinkView&) = default;
+};
+
+// Times that are not cached are left as 0.
+inline Dir DirView::ToDir(ReqScopedAlloc alloc) const {
+  return Dir{
+      .parent_id = GetParentID(),
+      .name = std::pmr::string(GetName(), alloc),
+      .id = GetID(),
+      .acl = GetAcl(),
+      .ctime_in_ns = GetCTimeInNs(),
+      .mtime_in_ns = GetMTimeInNs().value_or(0),
+      .atime_in_ns = GetATimeInNs().value_or(0),
+  };
+}
+
+inline HardLink HardLinkView::ToHardLink(ReqScopedAlloc alloc) const {
+  return HardLink{
+      .parent_id = GetParentID(),
+      .name = std::pmr::string(GetName(), alloc),
+      .id = GetID(),
+  };
+}
+
+// Lists the entries of one dir chunk by chunk, see `DEntViewBase::OpenList`.
+class DEntCursorBase {
+ public:
+  DEntCursorBase() = default;
+  DEntCursorBase(const DEntCursorBase&) = delete;
+  DEntCursorBase(DEntCursorBase&&) = delete;
+  DEntCursorBase& operator=(const DEntCursorBase&) = delete;
+  DEntCursorBase& operator=(DEntCursorBase&&) = delete;
+  virtual ~DEntCursorBase() = default;
+
+  // Returns up to `limit` more entries in name order, or none once the dir is
+  // exhausted. The views stay valid until the next call.
+  virtual unifex::task<std::expected<
+      std::span<const std::variant<const DirView*, const HardLinkView*>>,
+      Status>>
+  Next(size_t limit) = 0;
+};
+
 // -- The combination of (parent_id, name) serves as a primary key.
 // CREATE VIEW DirEntryView AS
 // SELECT
@@ -37,13 +130,26 @@ class DEntViewBase {
   DEntViewBase& operator=(DEntViewBase&&) = delete;
   virtual ~DEntViewBase() = default;
 
-  virtual unifex::task<
-      std::expected<std::variant<std::monostate, Dir, HardLink>, Status>>
+  // The returned views stay valid until this view is destroyed.
+  virtual unifex::task<std::expected<
+      std::variant<std::monostate, const DirView*, const HardLinkView*>,
+      Status>>
   Read(InodeID parent_id, std::string_view name) = 0;
 
-  virtual unifex::task<
-      std::expected<std::pmr::vector<std::variant<Dir, HardLink>>, Status>>
-  List(InodeID parent_id, std::string_view start_after, size_t limit) = 0;
+  // Reads the entries of `names`, i.e., (parent_id, name) pairs, in one batch,
+  // in the order of `names`.
+  virtual unifex::task<std::expected<
+      std::pmr::vector<
+          std::variant<std::monostate, const DirView*, const HardLinkView*>>,
+      Status>>
+  BatchRead(std::span<const std::pair<InodeID, std::string_view>> names) = 0;
+
+  // Lists the entries of `parent_id` after `start_after`, which may be empty,
+  // all at the snapshot of the txn. The view keeps no earlier chunk, so a dir
+  // of any size is listed in the memory of one chunk. The cursor must not
+  // outlive the view.
+  virtual std::unique_ptr<DEntCursorBase> OpenList(
+      InodeID parent_id, std::string_view start_after) = 0;
 };
 
 }  // namespace rocketfs
@@ -4,11 +4,16 @@
 
 #include <sys/stat.h>
 
+#include <climits>
 #include <cstdint>
 #include <expected>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <variant>
+#include <vector>
 
 #include <unifex/task.hpp>
 
@@ -84,6 +89,17 @@ inline std::expected<void, Status> CheckPermission(const Acl& acl,
   return {};
 }
 
+// Names longer than NAME_MAX are rejected up front, so keys built from them fit
+// in a `KVKey`.
+inline std::expected<void, Status> CheckName(std::string_view name) {
+  if (name.empty() || name.size() > NAME_MAX ||
+      name.find('/') != std::string_view::npos) {
+    return std::unexpected(Status::InvalidArgumentError(
+        fmt::format("Invalid name of {} bytes.", name.size())));
+  }
+  return {};
+}
+
 struct Dir {
   InodeID parent_id;
   std::pmr::string name;
@@ -117,6 +133,10 @@ class DirTableBase {
       InodeID id) = 0;
   virtual unifex::task<std::expected<std::optional<Dir>, Status>> Read(
       InodeID parent_id, std::string_view name) = 0;
+  // Reads the dirs of `ids` in one batch, in the order of `ids`.
+  virtual unifex::task<
+      std::expected<std::pmr::vector<std::optional<Dir>>, Status>>
+  BatchRead(std::span<const InodeID> ids) = 0;
   virtual void Write(const std::optional<Dir>& original,
                      const std::optional<Dir>& modified) = 0;
 };
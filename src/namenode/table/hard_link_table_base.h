@@ -10,7 +10,7 @@
 
 #include "common/status.h"
 #include "generated/inode_generated.h"
-#include "namenode/common/id_gen.h"
+#include "namenode/table/inode_id.h"
 
 namespace rocketfs {
 
@@ -5,7 +5,7 @@
 #include <cstdint>
 #include <limits>
 
-#include "namenode/common/id_gen.h"
+#include "namenode/common/leased_id_gen.h"
 
 namespace rocketfs {
 
@@ -24,6 +24,6 @@ inline bool operator!=(const InodeID& lhs, const InodeID& rhs) {
 constexpr InodeID kInvalidInodeID{std::numeric_limits<uint64_t>::max()};
 constexpr InodeID kRootInodeID{1};
 
-using InodeIDGen = IDGen<InodeID>;
+using InodeIDGen = LeasedIDGen<InodeID>;
 
 }  // namespace rocketfs
@@ -7,5 +7,74 @@ namespace rocketfs {
 DEFINE_string(rocksdb_kv_store_db_path,
               "/tmp/rocksdb",
               "The path for the RocksDB KVStore database.");
+DEFINE_int32(rocksdb_zstd_level,
+             3,
+             "The zstd level of the column families holding FlatBuffer "
+             "values, i.e., Inode and DEnt.");
+DEFINE_uint32(rocksdb_zstd_max_dict_bytes,
+              16 * 1024,
+              "The max size of the zstd dictionary trained per SST file of "
+              "the Inode and DEnt column families. 0 disables dictionaries.");
+DEFINE_uint64(rocksdb_zstd_max_train_bytes,
+              100 * 16 * 1024,
+              "The max num of sampled bytes a zstd dictionary is trained on. "
+              "0 uses the samples as the dictionary as is.");
+DEFINE_uint64(rocksdb_block_cache_bytes,
+              512ULL * 1024 * 1024,
+              "The capacity of the LRU block cache of the Inode and DEnt "
+              "column families, which holds uncompressed blocks.");
+DEFINE_uint64(rocksdb_compressed_block_cache_bytes,
+              1024ULL * 1024 * 1024,
+              "The capacity of the secondary cache behind the block cache of "
+              "the Inode and DEnt column families, which keeps the blocks "
+              "evicted from it zstd compressed. 0 disables it.");
+DEFINE_uint32(rocksdb_conflict_detector_max_txns,
+              100'000,
+              "The num of committed txns whose written keys are kept to "
+              "check later commits against. Txns that started before the "
+              "oldest of them fail with ConflictError and are retried.");
+DEFINE_uint32(rocksdb_retained_snapshot_ttl_ms,
+              30'000,
+              "How long a snapshot is retained for the next page of a paged "
+              "listing to read at. A page after that reads at a new one.");
+DEFINE_uint32(rocksdb_max_retained_snapshots,
+              1024,
+              "The max num of snapshots retained for paged listings. Each "
+              "keeps compactions from dropping the versions it sees.");
+
+DEFINE_string(kv_dir_layout,
+              "split",
+              "How dir attributes are laid out across column families: "
+              "`split`, `co_located` or `hybrid`. See `DirLayout`. Must not "
+              "change once the database has been written.");
+
+DEFINE_bool(dent_cache_dir_times,
+            true,
+            "Whether the dir entry of a dir also caches its mtime and atime, "
+            "so a lookup is answered by a single read. Either way, every "
+            "mtime or atime update of the dir also rewrites its dir entry, "
+            "which clears the copy while off, so that turning it back on "
+            "serves no stale times. Turning it off thus saves no writes.");
+
+DEFINE_string(
+    flatbuffer_verify_policy,
+    "always",
+    "How FlatBuffer values are verified: `always` verifies every value that "
+    "is read, `sampled` verifies one in every "
+    "`flatbuffer_verify_sample_interval` values that are read, and "
+    "`on_write` verifies values once when they are serialized and afterwards "
+    "trusts RocksDB block checksums and the background scrubber.");
+DEFINE_uint32(flatbuffer_verify_sample_interval,
+              1024,
+              "Verify one in every this many values that are read when "
+              "`flatbuffer_verify_policy` is `sampled`.");
+DEFINE_uint32(flatbuffer_scrub_interval_sec,
+              3600,
+              "The interval (in seconds) between two background scrubs of "
+              "the FlatBuffer values at rest. 0 disables scrubbing.");
+DEFINE_uint32(flatbuffer_scrub_entries_per_sec,
+              100000,
+              "The max num of values the background scrubber verifies per "
+              "second.");
 
 }  // namespace rocketfs
@@ -6,11 +6,16 @@
 
 #include <coroutine>
 #include <expected>
+#include <list>
+#include <memory>
 #include <memory_resource>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <unifex/coroutine.hpp>
 
@@ -20,15 +25,31 @@
 #include "namenode/table/hard_link_table_base.h"
 #include "namenode/table/inode_id.h"
 #include "namenode/table/kv/column_family.h"
+#include "namenode/table/kv/kv_dent_views.h"
+#include "namenode/table/kv/kv_key.h"
+#include "namenode/table/kv/kv_store_base.h"
 #include "namenode/table/kv/serde.h"
 
 namespace rocketfs {
 
+namespace {
+
+// Points at the view in `view` through the interface of its kind.
+template <typename DEnt>
+DEnt ToDEnt(const std::variant<KVDirView, KVHardLinkView>& view) {
+  return std::visit([](const auto& kv_view) -> DEnt { return &kv_view; },
+                    view);
+}
+
+}  // namespace
+
 KVDEntView::KVDEntView(TxnBase* txn, ReqScopedAlloc alloc)
-    : txn_(CHECK_NOTNULL(txn)), alloc_(alloc) {
+    : txn_(CHECK_NOTNULL(txn)), alloc_(alloc), vals_(alloc_), views_(alloc_) {
 }
 
-unifex::task<std::expected<std::variant<std::monostate, Dir, HardLink>, Status>>
+unifex::task<std::expected<
+    std::variant<std::monostate, const DirView*, const HardLinkView*>,
+    Status>>
 KVDEntView::Read(InodeID parent_id, std::string_view name) {
   auto dent_str = co_await txn_->Get(kDEntCFIndex,
                                      DEntSerde(alloc_).SerKey(parent_id, name));
@@ -43,37 +64,88 @@ KVDEntView::Read(InodeID parent_id, std::string_view name) {
   if (!*dent_str) {
     co_return std::monostate{};
   }
-  co_return std::visit(
-      [](auto&& arg) -> std::variant<std::monostate, Dir, HardLink> {
-        return std::forward<decltype(arg)>(arg);
-      },
-      DEntSerde(alloc_).DeVal(**dent_str));
+  const auto& val = vals_.emplace_back(std::move(**dent_str));
+  const auto& view = views_.emplace_back(DEntSerde(alloc_).DeView(val));
+  co_return ToDEnt<
+      std::variant<std::monostate, const DirView*, const HardLinkView*>>(view);
 }
 
-unifex::task<
-    std::expected<std::pmr::vector<std::variant<Dir, HardLink>>, Status>>
-KVDEntView::List(InodeID parent_id,
-                 std::string_view start_after,
-                 size_t limit) {
-  auto dent_strs =
-      co_await txn_->GetRange(kDEntCFIndex,
-                              DEntSerde(alloc_).SerKey(parent_id, start_after),
-                              DEntSerde(alloc_).SerKey(parent_id, "\xFF"),
-                              limit);
+unifex::task<std::expected<
+    std::pmr::vector<
+        std::variant<std::monostate, const DirView*, const HardLinkView*>>,
+    Status>>
+KVDEntView::BatchRead(
+    std::span<const std::pair<InodeID, std::string_view>> names) {
+  DEntSerde dent_serde(alloc_);
+  // Reserved up front, so that `keys` can point into it.
+  std::pmr::vector<KVKey> key_bufs(alloc_);
+  key_bufs.reserve(names.size());
+  std::pmr::vector<CFKey> keys(alloc_);
+  keys.reserve(names.size());
+  for (const auto& [parent_id, name] : names) {
+    keys.push_back(CFKey{
+        .cf_index = kDEntCFIndex,
+        .key = key_bufs.emplace_back(dent_serde.SerKey(parent_id, name))});
+  }
+  auto dent_strs = co_await txn_->MultiGet(keys);
   if (!dent_strs) {
-    co_return std::unexpected(
-        Status::SystemError(fmt::format("Failed to retrieve dir entries for "
-                                        "parent inode {} and start after {}.",
-                                        parent_id.val,
-                                        start_after),
-                            dent_strs.error()));
+    co_return std::unexpected(Status::SystemError(
+        fmt::format("Failed to retrieve {} dir entries.", names.size()),
+        dent_strs.error()));
   }
-  std::pmr::vector<std::variant<Dir, HardLink>> dents(alloc_);
-  dents.reserve(dent_strs->size());
-  for (const auto& dent_str : *dent_strs) {
-    dents.emplace_back(DEntSerde(alloc_).DeVal(dent_str));
+  std::pmr::vector<
+      std::variant<std::monostate, const DirView*, const HardLinkView*>>
+      dents(alloc_);
+  dents.reserve(names.size());
+  for (auto& dent_str : *dent_strs) {
+    if (!dent_str) {
+      dents.emplace_back(std::monostate{});
+      continue;
+    }
+    const auto& val = vals_.emplace_back(std::move(*dent_str));
+    const auto& view = views_.emplace_back(dent_serde.DeView(val));
+    dents.push_back(ToDEnt<
+        std::variant<std::monostate, const DirView*, const HardLinkView*>>(
+        view));
   }
   co_return dents;
 }
 
+std::unique_ptr<DEntCursorBase> KVDEntView::OpenList(
+    InodeID parent_id, std::string_view start_after) {
+  return std::make_unique<KVDEntCursor>(
+      txn_->NewRangeIter(kDEntCFIndex,
+                         DEntSerde(alloc_).SerKey(parent_id, start_after),
+                         DEntSerde(alloc_).SerKey(parent_id, "\xFF")),
+      alloc_);
+}
+
+KVDEntCursor::KVDEntCursor(std::unique_ptr<RangeIterBase> iter,
+                           ReqScopedAlloc alloc)
+    : iter_(CHECK_NOTNULL(std::move(iter))), dent_serde_(alloc) {
+}
+
+unifex::task<std::expected<
+    std::span<const std::variant<const DirView*, const HardLinkView*>>,
+    Status>>
+KVDEntCursor::Next(size_t limit) {
+  // The views of the last chunk point into `vals_`.
+  dents_.clear();
+  views_.clear();
+  auto read = co_await iter_->Next(limit, &vals_);
+  if (!read) {
+    co_return std::unexpected(Status::SystemError(
+        "Failed to retrieve the next chunk of dir entries.", read.error()));
+  }
+  for (const auto& val : vals_) {
+    views_.push_back(dent_serde_.DeView(val));
+  }
+  // Taken once `views_` is filled, so that no reallocation moves the views.
+  for (const auto& view : views_) {
+    dents_.push_back(
+        ToDEnt<std::variant<const DirView*, const HardLinkView*>>(view));
+  }
+  co_return dents_;
+}
+
 }  // namespace rocketfs
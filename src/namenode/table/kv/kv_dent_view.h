@@ -4,8 +4,13 @@
 
 #include <cstddef>
 #include <expected>
+#include <list>
+#include <memory>
 #include <memory_resource>
+#include <span>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -16,7 +21,9 @@
 #include "namenode/table/dent_view_base.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/hard_link_table_base.h"
+#include "namenode/table/kv/kv_dent_views.h"
 #include "namenode/table/kv/kv_store_base.h"
+#include "namenode/table/kv/serde.h"
 
 namespace rocketfs {
 
@@ -29,17 +36,52 @@ class KVDEntView : public DEntViewBase {
   KVDEntView& operator=(KVDEntView&&) = delete;
   ~KVDEntView() override = default;
 
-  unifex::task<
-      std::expected<std::variant<std::monostate, Dir, HardLink>, Status>>
+  unifex::task<std::expected<
+      std::variant<std::monostate, const DirView*, const HardLinkView*>,
+      Status>>
   Read(InodeID parent_id, std::string_view name) override;
 
-  unifex::task<
-      std::expected<std::pmr::vector<std::variant<Dir, HardLink>>, Status>>
-  List(InodeID parent_id, std::string_view start_after, size_t limit) override;
+  unifex::task<std::expected<
+      std::pmr::vector<
+          std::variant<std::monostate, const DirView*, const HardLinkView*>>,
+      Status>>
+  BatchRead(
+      std::span<const std::pair<InodeID, std::string_view>> names) override;
+
+  std::unique_ptr<DEntCursorBase> OpenList(
+      InodeID parent_id, std::string_view start_after) override;
 
  private:
   TxnBase* txn_;
   ReqScopedAlloc alloc_;
+  // Owns the values that returned views point into, and the views. A list
+  // keeps each at a stable address, including values short enough for SSO.
+  std::pmr::list<std::pmr::string> vals_;
+  std::pmr::list<std::variant<KVDirView, KVHardLinkView>> views_;
+};
+
+class KVDEntCursor : public DEntCursorBase {
+ public:
+  KVDEntCursor(std::unique_ptr<RangeIterBase> iter, ReqScopedAlloc alloc);
+  KVDEntCursor(const KVDEntCursor&) = delete;
+  KVDEntCursor(KVDEntCursor&&) = delete;
+  KVDEntCursor& operator=(const KVDEntCursor&) = delete;
+  KVDEntCursor& operator=(KVDEntCursor&&) = delete;
+  ~KVDEntCursor() override = default;
+
+  unifex::task<std::expected<
+      std::span<const std::variant<const DirView*, const HardLinkView*>>,
+      Status>>
+  Next(size_t limit) override;
+
+ private:
+  std::unique_ptr<RangeIterBase> iter_;
+  // Built once, so that decoding a chunk allocates nothing from the arena.
+  DEntSerde dent_serde_;
+  // Refilled by every chunk, keeping their capacity.
+  std::vector<std::string> vals_;
+  std::vector<std::variant<KVDirView, KVHardLinkView>> views_;
+  std::vector<std::variant<const DirView*, const HardLinkView*>> dents_;
 };
 
 }  // namespace rocketfs
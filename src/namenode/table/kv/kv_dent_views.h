@@ -0,0 +1,120 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "common/logger.h"
+#include "generated/dent_generated.h"
+#include "generated/inode_generated.h"
+#include "namenode/table/dent_view_base.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+// A `DirView` over the flatbuffer of a dir entry, see `DEntSerde::DeView`.
+class KVDirView final : public DirView {
+ public:
+  // The cached mtime and atime are ignored unless `with_cached_times` is set.
+  // An entry holds them only if they have not changed since caching was last
+  // on, see `DEntSerde::IsValueChanged`.
+  KVDirView(const serde::Dir* dir, bool with_cached_times);
+  KVDirView(const KVDirView&) = default;
+  KVDirView& operator=(const KVDirView&) = default;
+  ~KVDirView() override = default;
+
+  InodeID GetParentID() const override;
+  std::string_view GetName() const override;
+  InodeID GetID() const override;
+  Acl GetAcl() const override;
+  int64_t GetCTimeInNs() const override;
+  std::optional<int64_t> GetMTimeInNs() const override;
+  std::optional<int64_t> GetATimeInNs() const override;
+
+ private:
+  const serde::Dir* dir_;
+  bool with_cached_times_;
+};
+
+// A `HardLinkView` over the flatbuffer of a dir entry.
+class KVHardLinkView final : public HardLinkView {
+ public:
+  explicit KVHardLinkView(const serde::HardLink* hard_link);
+  KVHardLinkView(const KVHardLinkView&) = default;
+  KVHardLinkView& operator=(const KVHardLinkView&) = default;
+  ~KVHardLinkView() override = default;
+
+  InodeID GetParentID() const override;
+  std::string_view GetName() const override;
+  InodeID GetID() const override;
+
+ private:
+  const serde::HardLink* hard_link_;
+};
+
+inline KVDirView::KVDirView(const serde::Dir* dir, bool with_cached_times)
+    : dir_(CHECK_NOTNULL(dir)), with_cached_times_(with_cached_times) {
+}
+
+inline InodeID KVDirView::GetParentID() const {
+  return InodeID{dir_->parent_id()};
+}
+
+inline std::string_view KVDirView::GetName() const {
+  return dir_->name() == nullptr ? std::string_view()
+                                 : dir_->name()->string_view();
+}
+
+inline InodeID KVDirView::GetID() const {
+  return InodeID{dir_->id()};
+}
+
+inline Acl KVDirView::GetAcl() const {
+  auto acl = dir_->acl();
+  if (acl == nullptr) {
+    return Acl{};
+  }
+  return Acl{.uid = acl->uid(), .gid = acl->gid(), .perm = acl->perm()};
+}
+
+inline int64_t KVDirView::GetCTimeInNs() const {
+  return dir_->ctime_in_ns();
+}
+
+inline std::optional<int64_t> KVDirView::GetMTimeInNs() const {
+  auto mtime_in_ns = dir_->mtime_in_ns();
+  if (!with_cached_times_ || !mtime_in_ns.has_value()) {
+    return std::nullopt;
+  }
+  return *mtime_in_ns;
+}
+
+inline std::optional<int64_t> KVDirView::GetATimeInNs() const {
+  auto atime_in_ns = dir_->atime_in_ns();
+  if (!with_cached_times_ || !atime_in_ns.has_value()) {
+    return std::nullopt;
+  }
+  return *atime_in_ns;
+}
+
+inline KVHardLinkView::KVHardLinkView(const serde::HardLink* hard_link)
+    : hard_link_(CHECK_NOTNULL(hard_link)) {
+}
+
+inline InodeID KVHardLinkView::GetParentID() const {
+  return InodeID{hard_link_->parent_id()};
+}
+
+inline std::string_view KVHardLinkView::GetName() const {
+  return hard_link_->name() == nullptr ? std::string_view()
+                                       : hard_link_->name()->string_view();
+}
+
+inline InodeID KVHardLinkView::GetID() const {
+  return InodeID{hard_link_->id()};
+}
+
+}  // namespace rocketfs
@@ -9,9 +9,12 @@
 #include <expected>
 #include <memory_resource>
 #include <optional>
+#include <span>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <unifex/coroutine.hpp>
 
@@ -19,7 +22,10 @@
 #include "common/status.h"
 #include "namenode/table/inode_id.h"
 #include "namenode/table/kv/column_family.h"
+#include "namenode/table/kv/kv_dent_views.h"
+#include "namenode/table/kv/kv_key.h"
 #include "namenode/table/kv/kv_store_base.h"
+#include "namenode/table/kv/layout.h"
 #include "namenode/table/kv/serde.h"
 
 namespace rocketfs {
@@ -34,12 +40,14 @@ bool operator==(const std::optional<Dir>& lhs, const std::optional<Dir>& rhs) {
   return *lhs == *rhs;
 }
 
-KVDirTable::KVDirTable(TxnBase* txn, ReqScopedAlloc alloc)
+KVDirTable::KVDirTable(TxnBase* txn, ReqScopedAlloc alloc, DirLayout layout)
     : txn_(CHECK_NOTNULL(txn)),
       alloc_(alloc),
-      inode_serde_(alloc_),
+      layout_(layout),
+      inode_serde_(alloc_, layout_ == DirLayout::kCoLocated),
       mtime_serde_(alloc_),
       atime_serde_(alloc_),
+      times_serde_(alloc_),
       dent_serde_(alloc_) {
 }
 
@@ -54,14 +62,7 @@ unifex::task<std::expected<std::optional<Dir>, Status>> KVDirTable::Read(
   }
   if (!*inode_str) {
     if (id == kRootInodeID) {
-      co_return std::make_optional<Dir>(
-          Dir{.parent_id = kRootInodeID,
-              .name = "",
-              .id = kRootInodeID,
-              .acl = Acl{.uid = 0, .gid = 0, .perm = ALLPERMS},
-              .ctime_in_ns = 0,
-              .mtime_in_ns = 0,
-              .atime_in_ns = 0});
+      co_return MakeRootDir();
     }
     co_return std::nullopt;
   }
@@ -70,26 +71,12 @@ unifex::task<std::expected<std::optional<Dir>, Status>> KVDirTable::Read(
     co_return std::nullopt;
   }
   auto dir = std::get<Dir>(std::move(inode));
-
-  auto mtime_str =
-      co_await txn_->Get(kMTimeCFIndex, MTimeSerde(alloc_).SerKey(id));
-  if (!mtime_str) {
-    co_return std::unexpected(Status::SystemError(
-        fmt::format("Failed to retrieve mtime for inode {}.", id.val),
-        mtime_str.error()));
-  }
-  CHECK_NOTNULLOPT(*mtime_str);
-  dir.mtime_in_ns = MTimeSerde(alloc_).DeVal(**mtime_str);
-
-  auto atime_str =
-      co_await txn_->Get(kATimeCFIndex, ATimeSerde(alloc_).SerKey(id));
-  if (!atime_str) {
-    co_return std::unexpected(Status::SystemError(
-        fmt::format("Failed to retrieve atime for inode {}.", id.val),
-        atime_str.error()));
+  if (layout_ != DirLayout::kCoLocated) {
+    auto read_times = co_await ReadTimes(&dir);
+    if (!read_times) {
+      co_return std::unexpected(std::move(read_times).error());
+    }
   }
-  CHECK_NOTNULLOPT(*atime_str);
-  dir.atime_in_ns = ATimeSerde(alloc_).DeVal(**atime_str);
   co_return dir;
 }
 
@@ -108,19 +95,191 @@ unifex::task<std::expected<std::optional<Dir>, Status>> KVDirTable::Read(
   if (!*dent_str) {
     co_return std::nullopt;
   }
-  auto dent = DEntSerde(alloc_).DeVal(**dent_str);
-  if (!std::holds_alternative<Dir>(dent)) {
+  auto dent = DEntSerde(alloc_).DeView(**dent_str);
+  if (!std::holds_alternative<KVDirView>(dent)) {
     co_return std::nullopt;
   }
-  co_return std::get<Dir>(std::move(dent));
+  const auto& dir_view = std::get<KVDirView>(dent);
+  auto dir = dir_view.ToDir(alloc_);
+  if (!dir_view.GetMTimeInNs() || !dir_view.GetATimeInNs()) {
+    auto read_times = co_await ReadTimes(&dir);
+    if (!read_times) {
+      co_return std::unexpected(std::move(read_times).error());
+    }
+  }
+  co_return dir;
 }
 
+unifex::task<std::expected<std::pmr::vector<std::optional<Dir>>, Status>>
+KVDirTable::BatchRead(std::span<const InodeID> ids) {
+  // The keys of every dir, in the order of `ReadTimes`.
+  size_t keys_per_dir = 1;
+  switch (layout_) {
+    case DirLayout::kSplit:
+      keys_per_dir = 3;
+      break;
+    case DirLayout::kCoLocated:
+      break;
+    case DirLayout::kHybrid:
+      keys_per_dir = 2;
+      break;
+  }
+  // Reserved up front, so that `keys` can point into it.
+  std::pmr::vector<KVKey> key_bufs(alloc_);
+  key_bufs.reserve(ids.size() * keys_per_dir);
+  std::pmr::vector<CFKey> keys(alloc_);
+  keys.reserve(ids.size() * keys_per_dir);
+  for (auto id : ids) {
+    keys.push_back(
+        CFKey{.cf_index = kInodeCFIndex,
+              .key = key_bufs.emplace_back(inode_serde_.SerKey(id))});
+    switch (layout_) {
+      case DirLayout::kSplit:
+        keys.push_back(
+            CFKey{.cf_index = kMTimeCFIndex,
+                  .key = key_bufs.emplace_back(mtime_serde_.SerKey(id))});
+        keys.push_back(
+            CFKey{.cf_index = kATimeCFIndex,
+                  .key = key_bufs.emplace_back(atime_serde_.SerKey(id))});
+        break;
+      case DirLayout::kCoLocated:
+        break;
+      case DirLayout::kHybrid:
+        keys.push_back(
+            CFKey{.cf_index = kMTimeCFIndex,
+                  .key = key_bufs.emplace_back(times_serde_.SerKey(id))});
+        break;
+    }
+  }
+  auto vals = co_await txn_->MultiGet(keys);
+  if (!vals) {
+    co_return std::unexpected(Status::SystemError(
+        fmt::format("Failed to retrieve {} inodes.", ids.size()),
+        vals.error()));
+  }
+
+  std::pmr::vector<std::optional<Dir>> dirs(alloc_);
+  dirs.reserve(ids.size());
+  for (size_t i = 0; i < ids.size(); i++) {
+    const auto* dir_vals = &(*vals)[i * keys_per_dir];
+    if (!dir_vals[0]) {
+      dirs.push_back(ids[i] == kRootInodeID ? std::make_optional(MakeRootDir())
+                                            : std::nullopt);
+      continue;
+    }
+    auto inode = InodeSerde(alloc_).DeVal(*dir_vals[0]);
+    if (!std::holds_alternative<Dir>(inode)) {
+      dirs.push_back(std::nullopt);
+      continue;
+    }
+    auto& dir = dirs.emplace_back(std::get<Dir>(std::move(inode)));
+    switch (layout_) {
+      case DirLayout::kSplit:
+        CHECK_NOTNULLOPT(dir_vals[1]);
+        CHECK_NOTNULLOPT(dir_vals[2]);
+        dir->mtime_in_ns = MTimeSerde(alloc_).DeVal(*dir_vals[1]);
+        dir->atime_in_ns = ATimeSerde(alloc_).DeVal(*dir_vals[2]);
+        break;
+      case DirLayout::kCoLocated:
+        break;
+      case DirLayout::kHybrid:
+        CHECK_NOTNULLOPT(dir_vals[1]);
+        std::tie(dir->mtime_in_ns, dir->atime_in_ns) =
+            TimesSerde(alloc_).DeVal(*dir_vals[1]);
+        break;
+    }
+  }
+  co_return dirs;
+}
+
+Dir KVDirTable::MakeRootDir() {
+  return Dir{.parent_id = kRootInodeID,
+             .name = "",
+             .id = kRootInodeID,
+             .acl = Acl{.uid = 0, .gid = 0, .perm = ALLPERMS},
+             .ctime_in_ns = 0,
+             .mtime_in_ns = 0,
+             .atime_in_ns = 0};
+}
+
+unifex::task<std::expected<void, Status>> KVDirTable::ReadTimes(Dir* dir) {
+  if (layout_ == DirLayout::kCoLocated) {
+    auto inode_str =
+        co_await txn_->Get(kInodeCFIndex, InodeSerde(alloc_).SerKey(dir->id));
+    if (!inode_str) {
+      co_return std::unexpected(Status::SystemError(
+          fmt::format("Failed to retrieve inode for inode {}.", dir->id.val),
+          inode_str.error()));
+    }
+    if (!*inode_str) {
+      // The root dir is never written.
+      CHECK_EQ(dir->id, kRootInodeID);
+      co_return {};
+    }
+    auto inode = InodeSerde(alloc_).DeVal(**inode_str);
+    CHECK(std::holds_alternative<Dir>(inode));
+    dir->mtime_in_ns = std::get<Dir>(inode).mtime_in_ns;
+    dir->atime_in_ns = std::get<Dir>(inode).atime_in_ns;
+    co_return {};
+  }
+
+  if (layout_ == DirLayout::kHybrid) {
+    auto times_str =
+        co_await txn_->Get(kMTimeCFIndex, TimesSerde(alloc_).SerKey(dir->id));
+    if (!times_str) {
+      co_return std::unexpected(Status::SystemError(
+          fmt::format("Failed to retrieve times for inode {}.", dir->id.val),
+          times_str.error()));
+    }
+    CHECK_NOTNULLOPT(*times_str);
+    std::tie(dir->mtime_in_ns, dir->atime_in_ns) =
+        TimesSerde(alloc_).DeVal(**times_str);
+    co_return {};
+  }
+
+  auto mtime_str =
+      co_await txn_->Get(kMTimeCFIndex, MTimeSerde(alloc_).SerKey(dir->id));
+  if (!mtime_str) {
+    co_return std::unexpected(Status::SystemError(
+        fmt::format("Failed to retrieve mtime for inode {}.", dir->id.val),
+        mtime_str.error()));
+  }
+  CHECK_NOTNULLOPT(*mtime_str);
+  dir->mtime_in_ns = MTimeSerde(alloc_).DeVal(**mtime_str);
+
+  auto atime_str =
+      co_await txn_->Get(kATimeCFIndex, ATimeSerde(alloc_).SerKey(dir->id));
+  if (!atime_str) {
+    co_return std::unexpected(Status::SystemError(
+        fmt::format("Failed to retrieve atime for inode {}.", dir->id.val),
+        atime_str.error()));
+  }
+  CHECK_NOTNULLOPT(*atime_str);
+  dir->atime_in_ns = ATimeSerde(alloc_).DeVal(**atime_str);
+  co_return {};
+}
+
+// The dir entry caches the acl, ctime and possibly the times of the dir. It is
+// rewritten whenever any of them changes, so both copies are committed in the
+// same txn.
 void KVDirTable::Write(const std::optional<Dir>& orig,
                        const std::optional<Dir>& mod) {
   inode_serde_.Write(txn_, kInodeCFIndex, orig, mod);
-  mtime_serde_.Write(txn_, kMTimeCFIndex, orig, mod);
-  atime_serde_.Write(txn_, kATimeCFIndex, orig, mod);
-  dent_serde_.Write(txn_, kDEntCFIndex, orig, mod);
+  switch (layout_) {
+    case DirLayout::kSplit:
+      mtime_serde_.Write(txn_, kMTimeCFIndex, orig, mod);
+      atime_serde_.Write(txn_, kATimeCFIndex, orig, mod);
+      break;
+    case DirLayout::kCoLocated:
+      break;
+    case DirLayout::kHybrid:
+      times_serde_.Write(txn_, kMTimeCFIndex, orig, mod);
+      break;
+  }
+  // The root dir has no entry, and writing one would list it under itself.
+  if ((mod ? mod->id : orig->id) != kRootInodeID) {
+    dent_serde_.Write(txn_, kDEntCFIndex, orig, mod);
+  }
 }
 
 }  // namespace rocketfs
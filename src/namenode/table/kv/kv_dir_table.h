@@ -3,8 +3,11 @@
 #pragma once
 
 #include <expected>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <string_view>
+#include <vector>
 
 #include <unifex/task.hpp>
 
@@ -12,13 +15,14 @@
 #include "namenode/common/req_scoped_alloc.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/kv/kv_store_base.h"
+#include "namenode/table/kv/layout.h"
 #include "namenode/table/kv/serde.h"
 
 namespace rocketfs {
 
 class KVDirTable : public DirTableBase {
  public:
-  KVDirTable(TxnBase* txn, ReqScopedAlloc alloc);
+  KVDirTable(TxnBase* txn, ReqScopedAlloc alloc, DirLayout layout);
   KVDirTable(const KVDirTable&) = delete;
   KVDirTable(KVDirTable&&) = delete;
   KVDirTable& operator=(const KVDirTable&) = delete;
@@ -29,15 +33,26 @@ class KVDirTable : public DirTableBase {
       InodeID id) override;
   unifex::task<std::expected<std::optional<Dir>, Status>> Read(
       InodeID parent_id, std::string_view name) override;
+  // Takes a single `MultiGet` across the Inode and time column families.
+  unifex::task<std::expected<std::pmr::vector<std::optional<Dir>>, Status>>
+  BatchRead(std::span<const InodeID> ids) override;
   void Write(const std::optional<Dir>& original,
              const std::optional<Dir>& modified) override;
 
  private:
+  // The root dir is never written.
+  static Dir MakeRootDir();
+
+  // Fill in the mtime and atime of `dir` from wherever `layout_` stores them.
+  unifex::task<std::expected<void, Status>> ReadTimes(Dir* dir);
+
   TxnBase* txn_;
   ReqScopedAlloc alloc_;
+  DirLayout layout_;
   InodeSerde inode_serde_;
   MTimeSerde mtime_serde_;
   ATimeSerde atime_serde_;
+  TimesSerde times_serde_;
   DEntSerde dent_serde_;
 };
 
@@ -0,0 +1,79 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/table/kv/kv_id_leaser.h"
+
+#include <absl/base/internal/endian.h>
+#include <fmt/core.h>
+#include <quill/LogMacros.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "common/logger.h"
+
+namespace rocketfs {
+
+KVIDLeaser::KVIDLeaser(KVStoreBase* kv_store,
+                       std::string_view hwm_key,
+                       CFIndex id_cf,
+                       uint64_t min_id)
+    : kv_store_(CHECK_NOTNULL(kv_store)),
+      hwm_key_(hwm_key),
+      id_cf_(id_cf),
+      min_id_(min_id) {
+}
+
+std::expected<uint64_t, Status> KVIDLeaser::Lease(uint64_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!hwm_) {
+    auto hwm = LoadHWM();
+    if (!hwm) {
+      return std::unexpected(std::move(hwm).error());
+    }
+    hwm_ = *hwm;
+  }
+  auto first = *hwm_;
+  CHECK_LE(count, std::numeric_limits<uint64_t>::max() - first);
+  std::string hwm_str(sizeof(uint64_t), '\0');
+  absl::big_endian::Store64(hwm_str.data(), first + count);
+  auto put = kv_store_->PutSysVal(hwm_key_, hwm_str);
+  if (!put) {
+    return std::unexpected(Status::SystemError(
+        fmt::format("Failed to persist {} {}.", hwm_key_, first + count),
+        put.error()));
+  }
+  hwm_ = first + count;
+  return first;
+}
+
+std::expected<uint64_t, Status> KVIDLeaser::LoadHWM() {
+  auto hwm_str = kv_store_->GetSysVal(hwm_key_);
+  if (!hwm_str) {
+    return std::unexpected(Status::SystemError(
+        fmt::format("Failed to read {}.", hwm_key_), hwm_str.error()));
+  }
+  if (*hwm_str) {
+    CHECK_EQ((*hwm_str)->size(), sizeof(uint64_t));
+    return std::max<uint64_t>(absl::big_endian::Load64((*hwm_str)->data()),
+                              min_id_);
+  }
+
+  // The keys start with a big-endian ID, so the last key holds the largest.
+  auto last_key = kv_store_->GetLastKey(id_cf_);
+  if (!last_key) {
+    return std::unexpected(Status::SystemError(
+        fmt::format("Failed to seed {}.", hwm_key_), last_key.error()));
+  }
+  uint64_t hwm = min_id_;
+  if (*last_key) {
+    CHECK_GE((*last_key)->size(), sizeof(uint64_t));
+    hwm = std::max<uint64_t>(hwm,
+                             absl::big_endian::Load64((*last_key)->data()) + 1);
+  }
+  LOG_INFO(logger, "Seeded {} with {}.", hwm_key_, hwm);
+  return hwm;
+}
+
+}  // namespace rocketfs
@@ -0,0 +1,53 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "common/status.h"
+#include "namenode/common/leased_id_gen.h"
+#include "namenode/table/kv/column_family.h"
+#include "namenode/table/kv/kv_store_base.h"
+
+namespace rocketfs {
+
+constexpr std::string_view kInodeIDHWMKey{"inode_id_hwm"};
+
+// Persists the high-water mark of granted IDs under `hwm_key` before the grant
+// is returned, so no ID is granted twice across restarts.
+class KVIDLeaser : public IDLeaserBase {
+ public:
+  // Without a persisted high-water mark, e.g., in a namespace created before
+  // IDs were leased, the first grant starts after the largest key of `id_cf`,
+  // whose keys start with a big-endian ID, and at `min_id` at the earliest.
+  KVIDLeaser(KVStoreBase* kv_store,
+             std::string_view hwm_key,
+             CFIndex id_cf,
+             uint64_t min_id);
+  KVIDLeaser(const KVIDLeaser&) = delete;
+  KVIDLeaser(KVIDLeaser&&) = delete;
+  KVIDLeaser& operator=(const KVIDLeaser&) = delete;
+  KVIDLeaser& operator=(KVIDLeaser&&) = delete;
+  ~KVIDLeaser() override = default;
+
+  std::expected<uint64_t, Status> Lease(uint64_t count) override;
+
+ private:
+  std::expected<uint64_t, Status> LoadHWM();
+
+  KVStoreBase* kv_store_;
+  const std::string hwm_key_;
+  const CFIndex id_cf_;
+  const uint64_t min_id_;
+
+  std::mutex mutex_;
+  // The first ID that has not been granted yet.
+  std::optional<uint64_t> hwm_;
+};
+
+}  // namespace rocketfs
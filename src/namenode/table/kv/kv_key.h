@@ -0,0 +1,63 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <absl/base/internal/endian.h>
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "common/logger.h"
+#include "namenode/table/inode_id.h"
+
+namespace rocketfs {
+
+// A key encoded into an inline buffer, so building one never allocates. The
+// buffer fits the largest key there is, a dir entry key: an 8-byte parent inode
+// ID followed by a name of up to NAME_MAX bytes. Names are validated by the ops
+// (see `CheckName`) before they reach here.
+class KVKey {
+ public:
+  static constexpr size_t kCapacity = sizeof(InodeID) + NAME_MAX;
+
+  explicit KVKey(InodeID id);
+  KVKey(InodeID id, std::string_view suffix);
+  KVKey(const KVKey&) = default;
+  KVKey(KVKey&&) = default;
+  KVKey& operator=(const KVKey&) = default;
+  KVKey& operator=(KVKey&&) = default;
+  ~KVKey() = default;
+
+  std::string_view View() const;
+  // Lets a key be passed to `TxnBase` as is.
+  operator std::string_view() const;  // NOLINT(runtime/explicit)
+
+ private:
+  std::array<char, kCapacity> buf_;
+  uint16_t size_;
+};
+
+inline KVKey::KVKey(InodeID id) : size_(sizeof(InodeID)) {
+  static_assert(sizeof(InodeID) == sizeof(int64_t));
+  absl::big_endian::Store64(buf_.data(), id.val);
+}
+
+inline KVKey::KVKey(InodeID id, std::string_view suffix) : KVKey(id) {
+  CHECK_LE(suffix.size(), kCapacity - sizeof(InodeID));
+  std::memcpy(buf_.data() + size_, suffix.data(), suffix.size());
+  size_ += suffix.size();
+}
+
+inline std::string_view KVKey::View() const {
+  return std::string_view(buf_.data(), size_);
+}
+
+inline KVKey::operator std::string_view() const {
+  return View();
+}
+
+}  // namespace rocketfs
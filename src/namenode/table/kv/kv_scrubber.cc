@@ -0,0 +1,117 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/table/kv/kv_scrubber.h"
+
+#include <absl/strings/escaping.h>
+#include <gflags/gflags.h>
+#include <quill/LogMacros.h>
+#include <quill/core/ThreadContextManager.h>
+
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+
+#include "common/logger.h"
+#include "namenode/table/kv/column_family.h"
+#include "namenode/table/kv/serde.h"
+
+namespace rocketfs {
+
+DECLARE_uint32(flatbuffer_scrub_interval_sec);
+DECLARE_uint32(flatbuffer_scrub_entries_per_sec);
+
+KVScrubber::KVScrubber(KVStoreBase* kv_store)
+    : kv_store_(CHECK_NOTNULL(kv_store)) {
+}
+
+void KVScrubber::Start() {
+  CHECK_NULL(thread_);
+  if (FLAGS_flatbuffer_scrub_interval_sec == 0) {
+    return;
+  }
+  stopped_ = false;
+  thread_ = std::make_unique<std::thread>([this]() {
+    while (true) {
+      {
+        std::unique_lock lock(mutex_);
+        if (cv_.wait_for(lock,
+                         std::chrono::seconds(
+                             FLAGS_flatbuffer_scrub_interval_sec),
+                         [this]() { return stopped_; })) {
+          return;
+        }
+      }
+      ScrubOnce();
+    }
+  });
+}
+
+void KVScrubber::Stop() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  thread_->join();
+  thread_ = nullptr;
+}
+
+uint64_t KVScrubber::ScrubOnce() {
+  verified_in_window_ = 0;
+  uint64_t corrupted = 0;
+  for (auto [cf_index, verify] :
+       std::initializer_list<
+           std::pair<CFIndex, std::function<bool(std::string_view)>>>{
+           {kInodeCFIndex, &InodeSerde::Verify},
+           {kDEntCFIndex, &DEntSerde::Verify}}) {
+    auto scanned = kv_store_->Scan(
+        cf_index,
+        [&](std::string_view key, std::string_view value) {
+          if (!verify(value)) {
+            corrupted++;
+            LOG_ERROR(logger,
+                      "Value of key {} in column family {} failed "
+                      "verification.",
+                      absl::BytesToHexString(key),
+                      cf_index.index);
+          }
+          return Throttle();
+        });
+    if (!scanned) {
+      LOG_ERROR(logger,
+                "Failed to scrub column family {}: {}.",
+                cf_index.index,
+                scanned.error().GetMsg());
+    }
+  }
+  LOG_INFO(logger,
+           "Scrub finished, {} values failed verification.",
+           corrupted);
+  return corrupted;
+}
+
+// Waits only for the rest of the window once it is used up, so the time spent
+// verifying counts toward it.
+bool KVScrubber::Throttle() {
+  if (FLAGS_flatbuffer_scrub_entries_per_sec == 0) {
+    return true;
+  }
+  if (verified_in_window_++ == 0) {
+    window_start_ = std::chrono::steady_clock::now();
+  }
+  if (verified_in_window_ < FLAGS_flatbuffer_scrub_entries_per_sec) {
+    return true;
+  }
+  verified_in_window_ = 0;
+  std::unique_lock lock(mutex_);
+  return !cv_.wait_until(lock,
+                         window_start_ + std::chrono::seconds(1),
+                         [this]() { return stopped_; });
+}
+
+}  // namespace rocketfs
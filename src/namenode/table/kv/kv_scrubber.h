@@ -0,0 +1,50 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "namenode/table/kv/kv_store_base.h"
+
+namespace rocketfs {
+
+// Verifies the FlatBuffer values at rest in the background, so that read paths
+// may skip verification (see `flatbuffer_verify_policy`) without corrupted
+// values going unnoticed.
+class KVScrubber {
+ public:
+  explicit KVScrubber(KVStoreBase* kv_store);
+  KVScrubber(const KVScrubber&) = delete;
+  KVScrubber(KVScrubber&&) = delete;
+  KVScrubber& operator=(const KVScrubber&) = delete;
+  KVScrubber& operator=(KVScrubber&&) = delete;
+  ~KVScrubber() = default;
+
+  void Start();
+  void Stop();
+
+  // Scrubs every column family holding FlatBuffer values once and returns the
+  // num of values that failed verification.
+  uint64_t ScrubOnce();
+
+ private:
+  // Returns false if the scrubber was stopped meanwhile.
+  bool Throttle();
+
+ private:
+  KVStoreBase* kv_store_;
+  std::unique_ptr<std::thread> thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_{false};
+  // Throttles to `flatbuffer_scrub_entries_per_sec` in windows of a second.
+  std::chrono::steady_clock::time_point window_start_;
+  uint64_t verified_in_window_{0};
+};
+
+}  // namespace rocketfs
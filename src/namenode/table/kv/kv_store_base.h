@@ -2,20 +2,62 @@
 
 #include <cstdint>
 #include <expected>
+#include <functional>
 #include <memory>
 #include <memory_resource>
 #include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 #include <variant>
+#include <vector>
 
 #include <unifex/task.hpp>
 
 #include "common/status.h"
+#include "namenode/common/deadline.h"
 #include "namenode/common/req_scoped_alloc.h"
 #include "namenode/table/kv/column_family.h"
 
 namespace rocketfs {
 
+// The KV ops issued through a txn, e.g., for comparing physical layouts.
+struct KVStats {
+  uint64_t gets{0};
+  uint64_t multi_gets{0};
+  uint64_t range_gets{0};
+  uint64_t keys_read{0};
+  uint64_t bytes_read{0};
+  uint64_t puts{0};
+  uint64_t dels{0};
+  uint64_t bytes_written{0};
+};
+
+// A key of `TxnBase::MultiGet`.
+struct CFKey {
+  CFIndex cf_index;
+  std::string_view key;
+};
+
+// Reads a range of a column family chunk by chunk at the snapshot of the txn
+// it is opened from, keeping one iterator throughout rather than seeking again
+// for every chunk. Must not outlive the txn.
+class RangeIterBase {
+ public:
+  RangeIterBase() = default;
+  RangeIterBase(const RangeIterBase&) = delete;
+  RangeIterBase(RangeIterBase&&) = delete;
+  RangeIterBase& operator=(const RangeIterBase&) = delete;
+  RangeIterBase& operator=(RangeIterBase&&) = delete;
+  virtual ~RangeIterBase() = default;
+
+  // Overwrites `values` with up to `limit` more values, reusing the buffers of
+  // the strings already in it, so a scan of any length allocates no more than
+  // its largest chunk. Leaves `values` empty once the range is exhausted.
+  virtual unifex::task<std::expected<void, Status>> Next(
+      size_t limit, std::vector<std::string>* values) = 0;
+};
+
 class TxnBase {
  public:
   TxnBase() = default;
@@ -37,6 +79,14 @@ class TxnBase {
       // - `std::string_view value`: Key must exist with matching value.
       std::variant<std::monostate, std::optional<std::string_view>> value) = 0;
 
+  // Reads `keys`, which may span column families, in one batch at the snapshot
+  // of the txn. The values are in the order of `keys`.
+  virtual unifex::task<std::expected<
+      std::pmr::vector<std::optional<std::pmr::string>>,
+      Status>>
+  MultiGet(std::span<const CFKey> keys,
+           bool exclude_from_read_conflict = false) = 0;
+
   virtual unifex::task<
       std::expected<std::pmr::vector<std::pmr::string>, Status>>
   GetRange(CFIndex cf_index,
@@ -48,13 +98,39 @@ class TxnBase {
                                        // [start_key, end_key)
                                        std::string_view start_key,
                                        std::string_view end_key) = 0;
+  // Iterates the keys in (start_after, end_key), so that a scan can resume
+  // right after the last key it returned. Unlike `GetRange`, it adds no read
+  // conflict and is meant for read-only txns, e.g., for streaming a huge dir.
+  virtual std::unique_ptr<RangeIterBase> NewRangeIter(
+      CFIndex cf_index,
+      std::string_view start_after,
+      std::string_view end_key) = 0;
 
   virtual void Put(CFIndex cf_index,
                    std::string_view key,
                    std::string_view value) = 0;
   virtual void Del(CFIndex cf_index, std::string_view key) = 0;
+
+  virtual const KVStats& GetStats() const = 0;
+
+  // Once `deadline` expires, `Get` and `GetRange` fail with
+  // `DeadlineExceededError`, and so does `KVStoreBase::CommitTxn` without
+  // committing.
+  void SetDeadline(Deadline deadline);
+  const Deadline& GetDeadline() const;
+
+ private:
+  Deadline deadline_;
 };
 
+inline void TxnBase::SetDeadline(Deadline deadline) {
+  deadline_ = deadline;
+}
+
+inline const Deadline& TxnBase::GetDeadline() const {
+  return deadline_;
+}
+
 class KVStoreBase {
  public:
   KVStoreBase() = default;
@@ -67,6 +143,35 @@ class KVStoreBase {
   virtual std::unique_ptr<TxnBase> StartTxn(ReqScopedAlloc alloc) = 0;
   virtual unifex::task<std::expected<void, Status>> CommitTxn(
       std::unique_ptr<TxnBase> txn) = 0;
+
+  // Retains the snapshot of `txn` for a while, so that later txns can read at
+  // it through `StartTxnAt`, e.g., the pages of one listing. Returns the read
+  // version that names it.
+  virtual int64_t RetainSnapshot(TxnBase* txn) = 0;
+  // Starts a txn at the snapshot of `read_version`, or returns nullptr if the
+  // snapshot is no longer retained.
+  virtual std::unique_ptr<TxnBase> StartTxnAt(ReqScopedAlloc alloc,
+                                              int64_t read_version) = 0;
+
+  // Reads and durably writes a key of the default column family outside of any
+  // txn, for process-wide metadata such as ID high-water marks. The default
+  // column family is never accessed through txns.
+  virtual std::expected<std::optional<std::string>, Status> GetSysVal(
+      std::string_view key) = 0;
+  virtual std::expected<void, Status> PutSysVal(std::string_view key,
+                                                std::string_view value) = 0;
+
+  // Visits every key-value pair in `cf_index` outside of any txn, e.g., for
+  // background maintenance such as scrubbing. The scan must not evict hot
+  // entries from caches. `visitor` returns false to stop early.
+  virtual std::expected<void, Status> Scan(
+      CFIndex cf_index,
+      const std::function<bool(std::string_view key, std::string_view value)>&
+          visitor) = 0;
+  // Returns the largest key in `cf_index` outside of any txn, or
+  // `std::nullopt` if it is empty, with a single seek rather than a scan.
+  virtual std::expected<std::optional<std::string>, Status> GetLastKey(
+      CFIndex cf_index) = 0;
 };
 
 }  // namespace rocketfs
@@ -0,0 +1,49 @@
+// Copyright 2025 RocketFS
+
+#include "namenode/table/kv/layout.h"
+
+#include <fmt/core.h>
+#include <gflags/gflags.h>
+
+#include "common/logger.h"
+
+namespace rocketfs {
+
+DECLARE_string(kv_dir_layout);
+
+std::optional<DirLayout> ParseDirLayout(std::string_view name) {
+  if (name == "split") {
+    return DirLayout::kSplit;
+  }
+  if (name == "co_located") {
+    return DirLayout::kCoLocated;
+  }
+  if (name == "hybrid") {
+    return DirLayout::kHybrid;
+  }
+  return std::nullopt;
+}
+
+std::string_view DirLayoutName(DirLayout layout) {
+  switch (layout) {
+    case DirLayout::kSplit:
+      return "split";
+    case DirLayout::kCoLocated:
+      return "co_located";
+    case DirLayout::kHybrid:
+      return "hybrid";
+  }
+  return "unknown";
+}
+
+DirLayout GetDirLayout() {
+  static const DirLayout layout = []() {
+    auto layout = ParseDirLayout(FLAGS_kv_dir_layout);
+    Check(static_cast<bool>(layout),
+          fmt::format("Unknown kv_dir_layout {}", FLAGS_kv_dir_layout));
+    return *layout;
+  }();
+  return layout;
+}
+
+}  // namespace rocketfs
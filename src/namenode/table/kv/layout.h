@@ -0,0 +1,33 @@
+// Copyright 2025 RocketFS
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace rocketfs {
+
+// How the attributes of a dir are laid out across column families. Every
+// layout keeps the dir entry in the DEnt CF, so lookups by name are unaffected.
+// The layout is chosen per deployment (see `kv_dir_layout`) and must not change
+// once a database has been written.
+enum class DirLayout : uint8_t {
+  // Static attributes in the Inode CF, mtime in the DirectoryMTime CF and atime
+  // in the ATime CF. A getattr takes three reads, but time updates rewrite only
+  // 8-byte values.
+  kSplit,
+  // All attributes in a single Inode CF value. A getattr takes one read, but
+  // every time update rewrites the whole value.
+  kCoLocated,
+  // Static attributes in the Inode CF, and mtime and atime together in a single
+  // DirectoryMTime CF value. A getattr takes two reads.
+  kHybrid,
+};
+
+std::optional<DirLayout> ParseDirLayout(std::string_view name);
+std::string_view DirLayoutName(DirLayout layout);
+// The layout selected by `kv_dir_layout`.
+DirLayout GetDirLayout();
+
+}  // namespace rocketfs
@@ -5,19 +5,26 @@
 #include <gflags/gflags.h>
 #include <quill/LogMacros.h>
 #include <quill/core/ThreadContextManager.h>
+#include <rocksdb/advanced_options.h>
+#include <rocksdb/cache.h>
 #include <rocksdb/iterator.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/status.h>
+#include <rocksdb/table.h>
 #include <rocksdb/write_batch.h>
 
 #include <algorithm>
+#include <chrono>
 #include <coroutine>
 #include <expected>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
 #include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -35,21 +42,104 @@
 namespace rocketfs {
 
 DECLARE_string(rocksdb_kv_store_db_path);
+DECLARE_uint32(rocksdb_retained_snapshot_ttl_ms);
+DECLARE_uint32(rocksdb_max_retained_snapshots);
+DECLARE_int32(rocksdb_zstd_level);
+DECLARE_uint32(rocksdb_zstd_max_dict_bytes);
+DECLARE_uint64(rocksdb_zstd_max_train_bytes);
+DECLARE_uint64(rocksdb_block_cache_bytes);
+DECLARE_uint64(rocksdb_compressed_block_cache_bytes);
+DECLARE_uint32(rocksdb_conflict_detector_max_txns);
+
+namespace {
+
+// The Inode and DEnt CFs hold FlatBuffers of tens of bytes that share most of
+// their structure, e.g., vtables, union tags and Acl tables. Generic per-block
+// compression finds little to remove within a single block of such values, so
+// a zstd dictionary is trained on samples of each SST file instead.
+rocksdb::ColumnFamilyOptions FlatBufferCFOptions() {
+  rocksdb::ColumnFamilyOptions options;
+  rocksdb::CompressionOptions compression_opts;
+  compression_opts.level = FLAGS_rocksdb_zstd_level;
+  compression_opts.max_dict_bytes = FLAGS_rocksdb_zstd_max_dict_bytes;
+  compression_opts.zstd_max_train_bytes = FLAGS_rocksdb_zstd_max_train_bytes;
+  compression_opts.enabled = true;
+  options.compression = rocksdb::kZSTD;
+  options.compression_opts = compression_opts;
+  options.bottommost_compression = rocksdb::kZSTD;
+  options.bottommost_compression_opts = compression_opts;
+  rocksdb::BlockBasedTableOptions table_options;
+  table_options.block_cache = GetFlatBufferBlockCache();
+  options.table_factory.reset(
+      rocksdb::NewBlockBasedTableFactory(table_options));
+  return options;
+}
+
+}  // namespace
+
+// The block cache holds blocks uncompressed, so the dictionaries above shrink
+// only the disk and page cache footprint. Blocks evicted from it move to a
+// secondary cache that keeps them zstd compressed, which holds several times
+// as many values per byte and is still far cheaper to hit than a read.
+std::shared_ptr<rocksdb::Cache> GetFlatBufferBlockCache() {
+  static auto block_cache = [] {
+    rocksdb::LRUCacheOptions cache_options;
+    cache_options.capacity = FLAGS_rocksdb_block_cache_bytes;
+    if (FLAGS_rocksdb_compressed_block_cache_bytes > 0) {
+      rocksdb::CompressedSecondaryCacheOptions secondary_cache_options;
+      secondary_cache_options.capacity =
+          FLAGS_rocksdb_compressed_block_cache_bytes;
+      secondary_cache_options.compression_type = rocksdb::kZSTD;
+      cache_options.secondary_cache =
+          rocksdb::NewCompressedSecondaryCache(secondary_cache_options);
+    }
+    return rocksdb::NewLRUCache(cache_options);
+  }();
+  return block_cache;
+}
+
+std::vector<rocksdb::ColumnFamilyDescriptor> RocksDBCFDescriptors() {
+  return {rocksdb::ColumnFamilyDescriptor(std::string(kDefaultCFName), {}),
+          rocksdb::ColumnFamilyDescriptor(std::string(kInodeCFName),
+                                          FlatBufferCFOptions()),
+          rocksdb::ColumnFamilyDescriptor(std::string(kMTimeCFName), {}),
+          rocksdb::ColumnFamilyDescriptor(std::string(kATimeCFName), {}),
+          rocksdb::ColumnFamilyDescriptor(std::string(kDEntCFName),
+                                          FlatBufferCFOptions())};
+}
+
+RocksDBTxn::RocksDBTxn(
+    rocksdb::DB* db,
+    const std::vector<rocksdb::ColumnFamilyHandle*>& cf_handles,
+    int64_t start_version,
+    int64_t read_version,
+    ReqScopedAlloc alloc)
+    : RocksDBTxn(db,
+                 cf_handles,
+                 std::shared_ptr<const rocksdb::Snapshot>(
+                     CHECK_NOTNULL(CHECK_NOTNULL(db)->GetSnapshot()),
+                     [db](const auto* snapshot) {
+                       CHECK_NOTNULL(db);
+                       CHECK_NOTNULL(snapshot);
+                       db->ReleaseSnapshot(snapshot);
+                     }),
+                 start_version,
+                 read_version,
+                 alloc) {
+}
 
 RocksDBTxn::RocksDBTxn(
     rocksdb::DB* db,
     const std::vector<rocksdb::ColumnFamilyHandle*>& cf_handles,
+    std::shared_ptr<const rocksdb::Snapshot> snapshot,
     int64_t start_version,
+    int64_t read_version,
     ReqScopedAlloc alloc)
-    : db_(db),
+    : db_(CHECK_NOTNULL(db)),
       cf_handles_(cf_handles),
-      snapshot_(CHECK_NOTNULL(CHECK_NOTNULL(db_)->GetSnapshot()),
-                [db](const auto* snapshot) {
-                  CHECK_NOTNULL(db);
-                  CHECK_NOTNULL(snapshot);
-                  db->ReleaseSnapshot(snapshot);
-                }),
+      snapshot_(CHECK_NOTNULL(std::move(snapshot))),
       start_version_(start_version),
+      read_version_(read_version),
       commit_version_(-1),
       alloc_(alloc) {
 }
@@ -58,6 +148,9 @@ unifex::task<std::expected<std::optional<std::pmr::string>, Status>>
 RocksDBTxn::Get(CFIndex cf_index,
                 std::string_view key,
                 bool exclude_from_read_conflict) {
+  if (auto alive = GetDeadline().Check(); !alive) {
+    co_return std::unexpected(alive.error());
+  }
   rocksdb::ReadOptions read_options;
   read_options.snapshot = snapshot_.get();
   CHECK_NE(cf_index, kInvalidCFIndex);
@@ -66,7 +159,10 @@ RocksDBTxn::Get(CFIndex cf_index,
   rocksdb::PinnableSlice pinnable_slice;
   rocksdb::Status status =
       db_->Get(read_options, cf_handles_[cf_index.index], key, &pinnable_slice);
+  stats_.gets++;
   if (status.ok()) {
+    stats_.keys_read++;
+    stats_.bytes_read += key.size() + pinnable_slice.size();
     std::pmr::string value(alloc_);
     value.assign(pinnable_slice.data(), pinnable_slice.size());
     if (!exclude_from_read_conflict) {
@@ -96,12 +192,71 @@ void RocksDBTxn::AddReadConflictKey(
                 [this](std::string_view value) { return std::string(value); });
 }
 
+unifex::task<
+    std::expected<std::pmr::vector<std::optional<std::pmr::string>>, Status>>
+RocksDBTxn::MultiGet(std::span<const CFKey> keys,
+                     bool exclude_from_read_conflict) {
+  if (auto alive = GetDeadline().Check(); !alive) {
+    co_return std::unexpected(alive.error());
+  }
+  rocksdb::ReadOptions read_options;
+  read_options.snapshot = snapshot_.get();
+  std::pmr::vector<rocksdb::ColumnFamilyHandle*> cf_handles(alloc_);
+  std::pmr::vector<rocksdb::Slice> key_slices(alloc_);
+  cf_handles.reserve(keys.size());
+  key_slices.reserve(keys.size());
+  for (const auto& [cf_index, key] : keys) {
+    CHECK_NE(cf_index, kInvalidCFIndex);
+    CHECK_GE(cf_index.index, 0);
+    CHECK_LT(cf_index.index, cf_handles_.size());
+    cf_handles.push_back(cf_handles_[cf_index.index]);
+    key_slices.emplace_back(key);
+  }
+  std::pmr::vector<rocksdb::PinnableSlice> pinnable_slices(keys.size(),
+                                                           alloc_);
+  std::pmr::vector<rocksdb::Status> statuses(keys.size(), alloc_);
+  db_->MultiGet(read_options,
+                keys.size(),
+                cf_handles.data(),
+                key_slices.data(),
+                pinnable_slices.data(),
+                statuses.data());
+  stats_.multi_gets++;
+
+  std::pmr::vector<std::optional<std::pmr::string>> values(alloc_);
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    const auto& [cf_index, key] = keys[i];
+    if (statuses[i].IsNotFound()) {
+      if (!exclude_from_read_conflict) {
+        AddReadConflictKey(cf_index, key, std::monostate{});
+      }
+      values.emplace_back(std::nullopt);
+      continue;
+    }
+    if (!statuses[i].ok()) {
+      co_return std::unexpected(Status::SystemError(statuses[i].ToString()));
+    }
+    stats_.keys_read++;
+    stats_.bytes_read += key.size() + pinnable_slices[i].size();
+    auto& value = values.emplace_back(std::in_place, alloc_);
+    value->assign(pinnable_slices[i].data(), pinnable_slices[i].size());
+    if (!exclude_from_read_conflict) {
+      AddReadConflictKey(cf_index, key, std::string_view(*value));
+    }
+  }
+  co_return values;
+}
+
 unifex::task<std::expected<std::pmr::vector<std::pmr::string>, Status>>
 RocksDBTxn::GetRange(CFIndex cf_index,
                      std::string_view start_key,
                      std::string_view end_key,
                      size_t limit,
                      bool exclude_from_read_conflict) {
+  if (auto alive = GetDeadline().Check(); !alive) {
+    co_return std::unexpected(alive.error());
+  }
   rocksdb::ReadOptions read_options;
   read_options.snapshot = snapshot_.get();
   CHECK_NE(cf_index, kInvalidCFIndex);
@@ -115,7 +270,10 @@ RocksDBTxn::GetRange(CFIndex cf_index,
        values.size() < limit;
        iter->Next()) {
     values.emplace_back(iter->value().data(), iter->value().size());
+    stats_.keys_read++;
+    stats_.bytes_read += iter->key().size() + iter->value().size();
   }
+  stats_.range_gets++;
   if (!iter->status().ok()) {
     co_return std::unexpected(Status::SystemError(iter->status().ToString()));
   }
@@ -130,33 +288,91 @@ void RocksDBTxn::AddReadConflictKeyRange(CFIndex cf_index,
                                          std::string_view end_key) {
 }
 
+std::unique_ptr<RangeIterBase> RocksDBTxn::NewRangeIter(
+    CFIndex cf_index, std::string_view start_after, std::string_view end_key) {
+  rocksdb::ReadOptions read_options;
+  read_options.snapshot = snapshot_.get();
+  CHECK_NE(cf_index, kInvalidCFIndex);
+  CHECK_GE(cf_index.index, 0);
+  CHECK_LT(cf_index.index, cf_handles_.size());
+  auto iter = std::unique_ptr<rocksdb::Iterator>(
+      db_->NewIterator(read_options, cf_handles_[cf_index.index]));
+  iter->Seek(start_after);
+  if (iter->Valid() && iter->key().ToStringView() == start_after) {
+    iter->Next();
+  }
+  stats_.range_gets++;
+  return std::make_unique<RocksDBRangeIter>(this, std::move(iter), end_key);
+}
+
 void RocksDBTxn::Put(CFIndex cf_index,
                      std::string_view key,
                      std::string_view value) {
   CHECK_GE(cf_index.index, 0);
   CHECK_LT(cf_index.index, cf_handles_.size());
   write_set_[std::make_pair(cf_index, std::string(key))] = value;
+  stats_.puts++;
+  stats_.bytes_written += key.size() + value.size();
 }
 
 void RocksDBTxn::Del(CFIndex cf_index, std::string_view key) {
   CHECK_GE(cf_index.index, 0);
   CHECK_LT(cf_index.index, cf_handles_.size());
   write_set_[std::make_pair(cf_index, std::string(key))] = std::nullopt;
+  stats_.dels++;
+  stats_.bytes_written += key.size();
+}
+
+const KVStats& RocksDBTxn::GetStats() const {
+  return stats_;
+}
+
+RocksDBRangeIter::RocksDBRangeIter(RocksDBTxn* txn,
+                                   std::unique_ptr<rocksdb::Iterator> iter,
+                                   std::string_view end_key)
+    : txn_(CHECK_NOTNULL(txn)),
+      iter_(CHECK_NOTNULL(std::move(iter))),
+      end_key_(end_key) {
+}
+
+unifex::task<std::expected<void, Status>> RocksDBRangeIter::Next(
+    size_t limit, std::vector<std::string>* values) {
+  CHECK_NOTNULL(values);
+  if (auto alive = txn_->GetDeadline().Check(); !alive) {
+    co_return std::unexpected(alive.error());
+  }
+  size_t num = 0;
+  for (; iter_->Valid() && iter_->key().ToStringView() < end_key_ &&
+         num < limit;
+       iter_->Next()) {
+    if (num == values->size()) {
+      values->emplace_back();
+    }
+    (*values)[num++].assign(iter_->value().data(), iter_->value().size());
+    txn_->stats_.keys_read++;
+    txn_->stats_.bytes_read += iter_->key().size() + iter_->value().size();
+  }
+  values->resize(num);
+  if (!iter_->status().ok()) {
+    co_return std::unexpected(Status::SystemError(iter_->status().ToString()));
+  }
+  co_return {};
 }
 
 RocksDBConflictDetector::RocksDBConflictDetector(int64_t latest_purged_version)
     : latest_purged_version_(latest_purged_version) {
 }
 
-unifex::task<bool> RocksDBConflictDetector::IsConflictFree(
-    std::shared_ptr<const RocksDBTxn> txn) {
-  co_await mutex_.async_lock();
+std::mutex& RocksDBConflictDetector::GetMutex() {
+  return mutex_;
+}
 
-  CHECK_GT(txn->start_version_, 0);
-  CHECK_GT(txn->commit_version_, txn->start_version_);
-  if (txn->start_version_ < latest_purged_version_) {
-    mutex_.unlock();
-    co_return false;
+bool RocksDBConflictDetector::IsConflictFree(const RocksDBTxn& txn) {
+  CHECK_GT(txn.start_version_, 0);
+  CHECK_GT(txn.commit_version_, txn.start_version_);
+  CHECK_GE(txn.read_version_, 0);
+  if (txn.read_version_ < latest_purged_version_) {
+    return false;
   }
 
   // Ensuring no cycles in the direct serialization graph guarantees txn
@@ -171,59 +387,67 @@ unifex::task<bool> RocksDBConflictDetector::IsConflictFree(
   // 3. A txn is conflict free if and only if there have been no writes to any
   //    key that was read by that txn between the time the txn started and the
   //    commit time.
+  // The txns between are those whose writes `txn` may not have seen, even if
+  // they started after it, since a snapshot only sees visible writes.
   bool is_conflict_free =
-      !std::any_of(committed_txns_.lower_bound(txn->start_version_),
-                   committed_txns_.upper_bound(txn->commit_version_),
-                   [this, txn = txn.get()](const auto& p) {
-                     const auto& [version, prev_committed_txn] = p;
-                     CHECK_EQ(version, prev_committed_txn->commit_version_);
-                     return HasConflict(*txn, *prev_committed_txn);
+      !std::any_of(committed_txns_.upper_bound(txn.read_version_),
+                   committed_txns_.upper_bound(txn.commit_version_),
+                   [this, &txn](const auto& p) {
+                     const auto& [version, written_keys] = p;
+                     CHECK_LT(txn.read_version_, version);
+                     CHECK_GT(txn.commit_version_, version);
+                     return HasConflict(txn, written_keys);
                    });
   LOG_DEBUG(logger,
             "Txn {} is conflict-free: {}.",
-            txn->commit_version_,
+            txn.commit_version_,
             is_conflict_free);
-  mutex_.unlock();
-  co_return is_conflict_free;
+  if (is_conflict_free && !txn.write_set_.empty()) {
+    auto& written_keys = committed_txns_[txn.commit_version_];
+    written_keys.reserve(txn.write_set_.size());
+    for (const auto& [key_with_cf, value] : txn.write_set_) {
+      written_keys.push_back(key_with_cf);
+    }
+    if (committed_txns_.size() > FLAGS_rocksdb_conflict_detector_max_txns) {
+      PurgeTo(committed_txns_.begin()->first);
+    }
+  }
+  return is_conflict_free;
 }
 
 bool RocksDBConflictDetector::HasConflict(
-    const RocksDBTxn& txn, const RocksDBTxn& concurrent_txn) const {
-  CHECK_LT(txn.start_version_, concurrent_txn.commit_version_);
-  CHECK_GT(txn.commit_version_, concurrent_txn.commit_version_);
-  return std::any_of(concurrent_txn.write_set_.begin(),
-                     concurrent_txn.write_set_.end(),
-                     [&txn](const auto& p) {
-                       const auto& [key_with_cf, value] = p;
+    const RocksDBTxn& txn,
+    const WrittenKeys& concurrent_txn_written_keys) const {
+  return std::any_of(concurrent_txn_written_keys.begin(),
+                     concurrent_txn_written_keys.end(),
+                     [&txn](const auto& key_with_cf) {
                        return txn.read_set_.find(key_with_cf) !=
                               txn.read_set_.end();
                      });
 }
 
-unifex::task<void> RocksDBConflictDetector::PurgeTo(int64_t version) {
-  co_await mutex_.async_lock();
+// Must be called with `mutex_` held.
+void RocksDBConflictDetector::PurgeTo(int64_t version) {
   committed_txns_.erase(committed_txns_.begin(),
                         committed_txns_.upper_bound(version));
   if (version > latest_purged_version_) {
     latest_purged_version_ = version;
   }
-  mutex_.unlock();
 }
 
 RocksDBKVStore::RocksDBKVStore()
-    : version_(1), conflict_detector_(version_ - 1) {
+    : RocksDBKVStore(FLAGS_rocksdb_kv_store_db_path) {
+}
+
+RocksDBKVStore::RocksDBKVStore(const std::string& db_path)
+    : version_(1), visible_version_(0), conflict_detector_(0) {
   rocksdb::Options options;
   options.create_if_missing = true;
   options.create_missing_column_families = true;
   rocksdb::DB* db = nullptr;
-  std::vector<rocksdb::ColumnFamilyDescriptor> cf_descriptors{
-      rocksdb::ColumnFamilyDescriptor(std::string(kDefaultCFName), {}),
-      rocksdb::ColumnFamilyDescriptor(std::string(kInodeCFName), {}),
-      rocksdb::ColumnFamilyDescriptor(std::string(kMTimeCFName), {}),
-      rocksdb::ColumnFamilyDescriptor(std::string(kATimeCFName), {}),
-      rocksdb::ColumnFamilyDescriptor(std::string(kDEntCFName), {})};
-  auto status = rocksdb::DB::Open(
-      options, "/tmp/rocksdb", cf_descriptors, &cf_handles_, &db);
+  auto cf_descriptors = RocksDBCFDescriptors();
+  auto status =
+      rocksdb::DB::Open(options, db_path, cf_descriptors, &cf_handles_, &db);
   LOG_INFO(logger, "RocksDB open status: {}.", status.ToString());
   CHECK(status.ok());
   CHECK_EQ(cf_handles_.size(), cf_descriptors.size());
@@ -239,22 +463,83 @@ RocksDBKVStore::RocksDBKVStore()
   db_ = std::unique_ptr<rocksdb::DB>(db);
 }
 
+RocksDBKVStore::~RocksDBKVStore() {
+  // Column family handles must be destroyed before the database is closed.
+  for (auto* cf_handle : cf_handles_) {
+    CHECK(db_->DestroyColumnFamilyHandle(cf_handle).ok());
+  }
+  cf_handles_.clear();
+}
+
 std::unique_ptr<TxnBase> RocksDBKVStore::StartTxn(ReqScopedAlloc alloc) {
+  // Loaded before the txn takes its snapshot, which so sees at least the
+  // writes of `read_version`.
+  auto read_version = visible_version_.load(std::memory_order_acquire);
   return std::make_unique<RocksDBTxn>(
-      db_.get(), cf_handles_, version_.fetch_add(1), alloc);
+      db_.get(), cf_handles_, version_.fetch_add(1), read_version, alloc);
+}
+
+int64_t RocksDBKVStore::RetainSnapshot(TxnBase* txn) {
+  auto* rocksdb_txn = dynamic_cast<RocksDBTxn*>(CHECK_NOTNULL(txn));
+  CHECK_NOTNULL(rocksdb_txn);
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard lock(retained_snapshots_mutex_);
+  PurgeRetainedSnapshots(now);
+  auto [it, inserted] = retained_snapshots_.try_emplace(
+      rocksdb_txn->start_version_,
+      RetainedSnapshot{.snapshot = rocksdb_txn->snapshot_,
+                       .read_version = rocksdb_txn->read_version_});
+  it->second.expires_at =
+      now + std::chrono::milliseconds(FLAGS_rocksdb_retained_snapshot_ttl_ms);
+  if (inserted &&
+      retained_snapshots_.size() > FLAGS_rocksdb_max_retained_snapshots) {
+    // The one that expires first is the least recently retained.
+    retained_snapshots_.erase(std::min_element(
+        retained_snapshots_.begin(),
+        retained_snapshots_.end(),
+        [](const auto& lhs, const auto& rhs) {
+          return lhs.second.expires_at < rhs.second.expires_at;
+        }));
+  }
+  return rocksdb_txn->start_version_;
+}
+
+std::unique_ptr<TxnBase> RocksDBKVStore::StartTxnAt(ReqScopedAlloc alloc,
+                                                    int64_t read_version) {
+  std::shared_ptr<const rocksdb::Snapshot> snapshot;
+  int64_t snapshot_read_version = 0;
+  {
+    std::lock_guard lock(retained_snapshots_mutex_);
+    PurgeRetainedSnapshots(std::chrono::steady_clock::now());
+    auto it = retained_snapshots_.find(read_version);
+    if (it == retained_snapshots_.end()) {
+      return nullptr;
+    }
+    snapshot = it->second.snapshot;
+    snapshot_read_version = it->second.read_version;
+  }
+  return std::make_unique<RocksDBTxn>(db_.get(),
+                                      cf_handles_,
+                                      std::move(snapshot),
+                                      read_version,
+                                      snapshot_read_version,
+                                      alloc);
+}
+
+void RocksDBKVStore::PurgeRetainedSnapshots(
+    std::chrono::steady_clock::time_point now) {
+  std::erase_if(retained_snapshots_, [now](const auto& retained) {
+    return retained.second.expires_at <= now;
+  });
 }
 
 unifex::task<std::expected<void, Status>> RocksDBKVStore::CommitTxn(
     std::unique_ptr<TxnBase> txn) {
   auto rocksdb_txn =
-      std::shared_ptr<RocksDBTxn>(dynamic_cast<RocksDBTxn*>(txn.release()));
+      std::unique_ptr<RocksDBTxn>(dynamic_cast<RocksDBTxn*>(txn.release()));
   CHECK(static_cast<bool>(rocksdb_txn));
-  rocksdb_txn->commit_version_ = version_.fetch_add(1);
-  if (!co_await conflict_detector_.IsConflictFree(rocksdb_txn)) {
-    LOG_DEBUG(logger,
-              "Txn {} was aborted due to a conflict.",
-              rocksdb_txn->commit_version_);
-    co_return std::unexpected(Status::ConflictError());
+  if (auto alive = rocksdb_txn->GetDeadline().Check(); !alive) {
+    co_return std::unexpected(alive.error());
   }
   rocksdb::WriteBatch write_batch;
   for (const auto& [key_with_cf, value] : rocksdb_txn->write_set_) {
@@ -265,8 +550,92 @@ unifex::task<std::expected<void, Status>> RocksDBKVStore::CommitTxn(
       write_batch.Delete(cf_handles_[cf_index.index], key);
     }
   }
-  CHECK(db_->Write(rocksdb::WriteOptions(), &write_batch).ok());
-  co_return std::expected<void, Status>();
+  // The commit version is assigned, checked and applied in one critical
+  // section, so that txns are checked and become visible in commit version
+  // order, and `visible_version_` never runs ahead of the writes. This
+  // serializes WAL writes, so RocksDB cannot group commits, which caps commit
+  // throughput at one write at a time.
+  {
+    std::lock_guard lock(conflict_detector_.GetMutex());
+    rocksdb_txn->commit_version_ = version_.fetch_add(1);
+    if (conflict_detector_.IsConflictFree(*rocksdb_txn)) {
+      CHECK(db_->Write(rocksdb::WriteOptions(), &write_batch).ok());
+      visible_version_.store(rocksdb_txn->commit_version_,
+                             std::memory_order_release);
+      co_return std::expected<void, Status>();
+    }
+  }
+  LOG_DEBUG(logger,
+            "Txn {} was aborted due to a conflict.",
+            rocksdb_txn->commit_version_);
+  co_return std::unexpected(Status::ConflictError());
+}
+
+std::expected<std::optional<std::string>, Status> RocksDBKVStore::GetSysVal(
+    std::string_view key) {
+  std::string value;
+  auto status = db_->Get(rocksdb::ReadOptions(),
+                         cf_handles_[kDefaultCFIndex.index],
+                         key,
+                         &value);
+  if (status.IsNotFound()) {
+    return std::nullopt;
+  }
+  if (!status.ok()) {
+    return std::unexpected(Status::SystemError(status.ToString()));
+  }
+  return value;
+}
+
+std::expected<void, Status> RocksDBKVStore::PutSysVal(std::string_view key,
+                                                      std::string_view value) {
+  rocksdb::WriteOptions write_options;
+  write_options.sync = true;
+  auto status =
+      db_->Put(write_options, cf_handles_[kDefaultCFIndex.index], key, value);
+  if (!status.ok()) {
+    return std::unexpected(Status::SystemError(status.ToString()));
+  }
+  return {};
+}
+
+std::expected<void, Status> RocksDBKVStore::Scan(
+    CFIndex cf_index,
+    const std::function<bool(std::string_view key, std::string_view value)>&
+        visitor) {
+  CHECK_GE(cf_index.index, 0);
+  CHECK_LT(cf_index.index, cf_handles_.size());
+  rocksdb::ReadOptions read_options;
+  read_options.fill_cache = false;
+  auto iter = std::unique_ptr<rocksdb::Iterator>(
+      db_->NewIterator(read_options, cf_handles_[cf_index.index]));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    if (!visitor(iter->key().ToStringView(), iter->value().ToStringView())) {
+      break;
+    }
+  }
+  if (!iter->status().ok()) {
+    return std::unexpected(Status::SystemError(iter->status().ToString()));
+  }
+  return {};
+}
+
+std::expected<std::optional<std::string>, Status> RocksDBKVStore::GetLastKey(
+    CFIndex cf_index) {
+  CHECK_GE(cf_index.index, 0);
+  CHECK_LT(cf_index.index, cf_handles_.size());
+  rocksdb::ReadOptions read_options;
+  read_options.fill_cache = false;
+  auto iter = std::unique_ptr<rocksdb::Iterator>(
+      db_->NewIterator(read_options, cf_handles_[cf_index.index]));
+  iter->SeekToLast();
+  if (!iter->status().ok()) {
+    return std::unexpected(Status::SystemError(iter->status().ToString()));
+  }
+  if (!iter->Valid()) {
+    return std::nullopt;
+  }
+  return iter->key().ToString();
 }
 
 }  // namespace rocketfs
@@ -1,7 +1,11 @@
+#include <rocksdb/cache.h>
 #include <rocksdb/db.h>
+#include <rocksdb/iterator.h>
+#include <rocksdb/options.h>
 #include <rocksdb/snapshot.h>
 
 #include <atomic>
+#include <chrono>
 #include <compare>
 #include <cstddef>
 #include <cstdint>
@@ -11,14 +15,15 @@
 #include <map>
 #include <memory>
 #include <memory_resource>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <variant>
 #include <vector>
 
-#include <unifex/async_mutex.hpp>
 #include <unifex/task.hpp>
 
 #include "common/status.h"
@@ -34,9 +39,16 @@ constexpr std::string_view kMTimeCFName{"DirectoryMTime"};
 constexpr std::string_view kATimeCFName{"ATime"};
 constexpr std::string_view kDEntCFName{"DEnt"};
 
+// The column families in `CFIndex` order, with their options.
+std::vector<rocksdb::ColumnFamilyDescriptor> RocksDBCFDescriptors();
+// The block cache shared by the Inode and DEnt column families, see
+// `rocksdb_block_cache_bytes` and `rocksdb_compressed_block_cache_bytes`.
+std::shared_ptr<rocksdb::Cache> GetFlatBufferBlockCache();
+
 class RocksDBTxn : public TxnBase {
   friend class RocksDBKVStore;
   friend class RocksDBConflictDetector;
+  friend class RocksDBRangeIter;
 
   struct Comparator {
     bool operator()(const std::pair<CFIndex, std::string>& lhs,
@@ -47,9 +59,19 @@ class RocksDBTxn : public TxnBase {
   };
 
  public:
+  // `read_version` is the latest commit version visible before the snapshot
+  // of the txn is taken.
+  RocksDBTxn(rocksdb::DB* db,
+             const std::vector<rocksdb::ColumnFamilyHandle*>& cf_handles,
+             int64_t start_version,
+             int64_t read_version,
+             ReqScopedAlloc alloc);
+  // Reads at `snapshot`, which the txn of `start_version` took.
   RocksDBTxn(rocksdb::DB* db,
              const std::vector<rocksdb::ColumnFamilyHandle*>& cf_handles,
+             std::shared_ptr<const rocksdb::Snapshot> snapshot,
              int64_t start_version,
+             int64_t read_version,
              ReqScopedAlloc alloc);
   RocksDBTxn(const RocksDBTxn&) = delete;
   RocksDBTxn(RocksDBTxn&&) = delete;
@@ -67,6 +89,12 @@ class RocksDBTxn : public TxnBase {
       std::variant<std::monostate, std::optional<std::string_view>> value)
       override;
 
+  unifex::task<std::expected<
+      std::pmr::vector<std::optional<std::pmr::string>>,
+      Status>>
+  MultiGet(std::span<const CFKey> keys,
+           bool exclude_from_read_conflict) override;
+
   unifex::task<std::expected<std::pmr::vector<std::pmr::string>, Status>>
   GetRange(CFIndex cf_index,
            std::string_view start_key,
@@ -76,20 +104,28 @@ class RocksDBTxn : public TxnBase {
   void AddReadConflictKeyRange(CFIndex cf_index,
                                std::string_view start_key,
                                std::string_view end_key) override;
+  std::unique_ptr<RangeIterBase> NewRangeIter(
+      CFIndex cf_index,
+      std::string_view start_after,
+      std::string_view end_key) override;
 
   void Put(CFIndex cf_index,
            std::string_view key,
            std::string_view value) override;
   void Del(CFIndex cf_index, std::string_view key) override;
 
+  const KVStats& GetStats() const override;
+
  private:
   rocksdb::DB* db_;
   const std::vector<rocksdb::ColumnFamilyHandle*>& cf_handles_;
-  std::unique_ptr<const rocksdb::Snapshot,
-                  std::function<void(const rocksdb::Snapshot*)>>
-      snapshot_;
+  // Shared with `RocksDBKVStore` once retained.
+  std::shared_ptr<const rocksdb::Snapshot> snapshot_;
 
   int64_t start_version_;
+  // Every txn committed at or below it is visible to `snapshot_`, so only the
+  // ones above it are checked for conflicts.
+  int64_t read_version_;
   int64_t commit_version_;
   std::map<std::pair<CFIndex, std::string>,
            std::variant<std::monostate, std::optional<std::string>>,
@@ -100,48 +136,123 @@ class RocksDBTxn : public TxnBase {
            Comparator>
       write_set_;
 
+  KVStats stats_;
   ReqScopedAlloc alloc_;
 };
 
+class RocksDBRangeIter : public RangeIterBase {
+ public:
+  RocksDBRangeIter(RocksDBTxn* txn,
+                   std::unique_ptr<rocksdb::Iterator> iter,
+                   std::string_view end_key);
+  RocksDBRangeIter(const RocksDBRangeIter&) = delete;
+  RocksDBRangeIter(RocksDBRangeIter&&) = delete;
+  RocksDBRangeIter& operator=(const RocksDBRangeIter&) = delete;
+  RocksDBRangeIter& operator=(RocksDBRangeIter&&) = delete;
+  ~RocksDBRangeIter() override = default;
+
+  unifex::task<std::expected<void, Status>> Next(
+      size_t limit, std::vector<std::string>* values) override;
+
+ private:
+  RocksDBTxn* txn_;
+  std::unique_ptr<rocksdb::Iterator> iter_;
+  std::string end_key_;
+};
+
+// Remembers the keys written by the last `rocksdb_conflict_detector_max_txns`
+// committed txns. Txns that started before the oldest of them are aborted, as
+// they can no longer be checked.
 class RocksDBConflictDetector {
  public:
   explicit RocksDBConflictDetector(int64_t latest_purged_version);
+  RocksDBConflictDetector(const RocksDBConflictDetector&) = delete;
   RocksDBConflictDetector(RocksDBConflictDetector&&) = delete;
   RocksDBConflictDetector& operator=(const RocksDBConflictDetector&) = delete;
   RocksDBConflictDetector& operator=(RocksDBConflictDetector&&) = delete;
   ~RocksDBConflictDetector() = default;
 
-  unifex::task<bool> IsConflictFree(std::shared_ptr<const RocksDBTxn> txn);
+  // Held from assigning a commit version until its writes are visible, see
+  // `RocksDBKVStore::CommitTxn`. Nothing under it suspends, so a plain mutex
+  // blocks no thread for longer than one write.
+  std::mutex& GetMutex();
+
+  // Records the writes of `txn` if it is conflict free, so that the txns
+  // committing after it are checked against them. Must be called with
+  // `GetMutex()` held.
+  bool IsConflictFree(const RocksDBTxn& txn);
 
  private:
+  // Copies of the written keys, so that a committed txn, which holds a
+  // snapshot and points into the arena of its req, is not kept alive.
+  using WrittenKeys = std::vector<std::pair<CFIndex, std::string>>;
+
   bool HasConflict(const RocksDBTxn& txn,
-                   const RocksDBTxn& concurrent_txn) const;
-  unifex::task<void> PurgeTo(int64_t version);
+                   const WrittenKeys& concurrent_txn_written_keys) const;
+  void PurgeTo(int64_t version);
 
  private:
-  unifex::async_mutex mutex_;
-  std::map<int64_t, std::shared_ptr<RocksDBTxn>> committed_txns_;
+  std::mutex mutex_;
+  std::map<int64_t, WrittenKeys> committed_txns_;
   int64_t latest_purged_version_;
 };
 
 class RocksDBKVStore : public KVStoreBase {
  public:
+  // Opens the database at `rocksdb_kv_store_db_path`.
   RocksDBKVStore();
+  explicit RocksDBKVStore(const std::string& db_path);
   RocksDBKVStore(const RocksDBKVStore&) = delete;
   RocksDBKVStore(RocksDBKVStore&&) = delete;
   RocksDBKVStore& operator=(const RocksDBKVStore&) = delete;
   RocksDBKVStore& operator=(RocksDBKVStore&&) = delete;
-  ~RocksDBKVStore() override = default;
+  ~RocksDBKVStore() override;
 
   std::unique_ptr<TxnBase> StartTxn(ReqScopedAlloc alloc) override;
   unifex::task<std::expected<void, Status>> CommitTxn(
       std::unique_ptr<TxnBase> txn) override;
 
+  // A snapshot is retained for `rocksdb_retained_snapshot_ttl_ms` after it was
+  // last retained. At most `rocksdb_max_retained_snapshots` are, since each
+  // keeps compactions from dropping the versions it sees.
+  int64_t RetainSnapshot(TxnBase* txn) override;
+  std::unique_ptr<TxnBase> StartTxnAt(ReqScopedAlloc alloc,
+                                      int64_t read_version) override;
+
+  std::expected<std::optional<std::string>, Status> GetSysVal(
+      std::string_view key) override;
+  std::expected<void, Status> PutSysVal(std::string_view key,
+                                        std::string_view value) override;
+
+  std::expected<void, Status> Scan(
+      CFIndex cf_index,
+      const std::function<bool(std::string_view key, std::string_view value)>&
+          visitor) override;
+  std::expected<std::optional<std::string>, Status> GetLastKey(
+      CFIndex cf_index) override;
+
  private:
   std::unique_ptr<rocksdb::DB> db_;
   std::vector<rocksdb::ColumnFamilyHandle*> cf_handles_;
+  // Hands out both start and commit versions.
   std::atomic<int64_t> version_;
+  // The version of the last txn whose writes are visible. Only advanced under
+  // the lock of `conflict_detector_`, so in commit version order.
+  std::atomic<int64_t> visible_version_;
   RocksDBConflictDetector conflict_detector_;
+
+  struct RetainedSnapshot {
+    std::shared_ptr<const rocksdb::Snapshot> snapshot;
+    int64_t read_version;
+    std::chrono::steady_clock::time_point expires_at;
+  };
+  // Called with `retained_snapshots_mutex_` held.
+  void PurgeRetainedSnapshots(std::chrono::steady_clock::time_point now);
+
+  std::mutex retained_snapshots_mutex_;
+  // By the start versions of the txns that took them. Released before `db_`
+  // is closed, as members are destroyed in reverse order.
+  std::map<int64_t, RetainedSnapshot> retained_snapshots_;
 };
 
 }  // namespace rocketfs
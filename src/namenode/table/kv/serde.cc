@@ -7,20 +7,63 @@
 #include <flatbuffers/flatbuffer_builder.h>
 #include <flatbuffers/string.h>
 #include <flatbuffers/verifier.h>
+#include <fmt/core.h>
+#include <gflags/gflags.h>
 
 #include <cstddef>
-#include <cstring>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <variant>
 
 #include "common/logger.h"
 #include "generated/dent_generated.h"
 #include "generated/inode_generated.h"
+#include "namenode/table/kv/kv_dent_views.h"
 
 namespace rocketfs {
 
+DECLARE_bool(dent_cache_dir_times);
+DECLARE_string(flatbuffer_verify_policy);
+DECLARE_uint32(flatbuffer_verify_sample_interval);
+
 constexpr auto kDefaultFlatBufferBuilderSize = 128;
 
+FBVerifyPolicy GetFBVerifyPolicy() {
+  static const FBVerifyPolicy policy = []() {
+    if (FLAGS_flatbuffer_verify_policy == "always") {
+      return FBVerifyPolicy::kAlways;
+    }
+    if (FLAGS_flatbuffer_verify_policy == "sampled") {
+      CHECK_GT(FLAGS_flatbuffer_verify_sample_interval, 0);
+      return FBVerifyPolicy::kSampled;
+    }
+    Check(FLAGS_flatbuffer_verify_policy == "on_write",
+          fmt::format("Unknown flatbuffer_verify_policy {}",
+                      FLAGS_flatbuffer_verify_policy));
+    return FBVerifyPolicy::kOnWrite;
+  }();
+  return policy;
+}
+
+bool ShouldVerifyOnRead() {
+  switch (GetFBVerifyPolicy()) {
+    case FBVerifyPolicy::kAlways:
+      return true;
+    case FBVerifyPolicy::kSampled: {
+      thread_local uint32_t reads = 0;
+      return reads++ % FLAGS_flatbuffer_verify_sample_interval == 0;
+    }
+    case FBVerifyPolicy::kOnWrite:
+      return false;
+  }
+  return true;
+}
+
+bool ShouldVerifyOnWrite() {
+  return GetFBVerifyPolicy() == FBVerifyPolicy::kOnWrite;
+}
+
 FBAllocator::FBAllocator(ReqScopedAlloc alloc) : alloc_(alloc) {
 }
 
@@ -32,16 +75,32 @@ void FBAllocator::deallocate(uint8_t* p, size_t size) {
   alloc_.deallocate(p, size);
 }
 
-DetachedBuffer::DetachedBuffer(flatbuffers::DetachedBuffer&& buffer)
-    : buffer_(std::move(buffer)) {
+namespace {
+
+std::string_view FinishedBuffer(const flatbuffers::FlatBufferBuilder& fbb) {
+  return std::string_view(reinterpret_cast<const char*>(fbb.GetBufferPointer()),
+                          fbb.GetSize());
 }
 
-DetachedBuffer::operator std::string_view() const {
-  return std::string_view(reinterpret_cast<const char*>(buffer_.data()),
-                          buffer_.size());
+flatbuffers::Offset<serde::Acl> CreateAcl(flatbuffers::FlatBufferBuilder& fbb,
+                                          const Acl& acl) {
+  return serde::CreateAcl(fbb, acl.uid, acl.gid, acl.perm);
 }
 
-InodeSerde::InodeSerde(ReqScopedAlloc alloc) : alloc_(alloc), fb_alloc_(alloc) {
+Acl DeAcl(const serde::Acl* acl) {
+  if (acl == nullptr) {
+    return Acl{};
+  }
+  return Acl{.uid = acl->uid(), .gid = acl->gid(), .perm = acl->perm()};
+}
+
+}  // namespace
+
+InodeSerde::InodeSerde(ReqScopedAlloc alloc, bool with_times)
+    : alloc_(alloc),
+      with_times_(with_times),
+      fb_alloc_(alloc),
+      fbb_(kDefaultFlatBufferBuilderSize, &fb_alloc_) {
 }
 
 bool InodeSerde::IsKeyChanged(const Dir& orig, const Dir& mod) const {
@@ -53,9 +112,13 @@ bool InodeSerde::IsKeyChanged(const File& orig, const File& mod) const {
 }
 
 bool InodeSerde::IsValueChanged(const Dir& orig, const Dir& mod) const {
-  return orig.parent_id != mod.parent_id || orig.name != mod.name ||
-         orig.id != mod.id || orig.acl != mod.acl ||
-         orig.ctime_in_ns != mod.ctime_in_ns;
+  if (orig.parent_id != mod.parent_id || orig.name != mod.name ||
+      orig.id != mod.id || orig.acl != mod.acl ||
+      orig.ctime_in_ns != mod.ctime_in_ns) {
+    return true;
+  }
+  return with_times_ && (orig.mtime_in_ns != mod.mtime_in_ns ||
+                         orig.atime_in_ns != mod.atime_in_ns);
 }
 
 bool InodeSerde::IsValueChanged(const File& orig, const File& mod) const {
@@ -63,48 +126,56 @@ bool InodeSerde::IsValueChanged(const File& orig, const File& mod) const {
          orig.ctime_in_ns != mod.ctime_in_ns;
 }
 
-std::pmr::string InodeSerde::SerKey(InodeID id) {
-  std::pmr::string inode_id_str(alloc_);
-  inode_id_str.resize(sizeof(InodeID));
-  static_assert(sizeof(InodeID) == sizeof(int64_t));
-  absl::big_endian::Store64(inode_id_str.data(), id.val);
-  return inode_id_str;
+KVKey InodeSerde::SerKey(InodeID id) {
+  return KVKey(id);
 }
 
-std::pmr::string InodeSerde::SerKey(const Dir& dir) {
+KVKey InodeSerde::SerKey(const Dir& dir) {
   return SerKey(dir.id);
 }
 
-std::pmr::string InodeSerde::SerKey(const File& file) {
+KVKey InodeSerde::SerKey(const File& file) {
   return SerKey(file.id);
 }
 
-DetachedBuffer InodeSerde::SerVal(const Dir& dir) {
-  serde::DirT serde_dir;
-  serde_dir.parent_id = dir.parent_id.val;
-  serde_dir.name = dir.name;
-  serde_dir.id = dir.id.val;
-  serde_dir.ctime_in_ns = dir.ctime_in_ns;
-  serde::InodeTypeUnion type;
-  type.Set(std::move(serde_dir));
-  serde::InodeT serde_inode;
-  serde_inode.type = std::move(type);
-  flatbuffers::FlatBufferBuilder fbb(kDefaultFlatBufferBuilderSize, &fb_alloc_);
-  fbb.Finish(serde::Inode::Pack(fbb, &serde_inode));
-  return DetachedBuffer(fbb.Release());
-}
-
-DetachedBuffer InodeSerde::SerVal(const File& file) {
-  serde::FileT serde_file;
-  serde_file.id = file.id.val;
-  serde_file.ctime_in_ns = file.ctime_in_ns;
-  serde::InodeTypeUnion type;
-  type.Set(std::move(serde_file));
-  serde::InodeT serde_inode;
-  serde_inode.type = std::move(type);
-  flatbuffers::FlatBufferBuilder fbb(kDefaultFlatBufferBuilderSize, &fb_alloc_);
-  fbb.Finish(serde::Inode::Pack(fbb, &serde_inode));
-  return DetachedBuffer(fbb.Release());
+std::string_view InodeSerde::SerVal(const Dir& dir) {
+  fbb_.Clear();
+  auto name = fbb_.CreateString(dir.name.data(), dir.name.size());
+  auto acl = CreateAcl(fbb_, dir.acl);
+  flatbuffers::Optional<int64_t> mtime_in_ns = flatbuffers::nullopt;
+  flatbuffers::Optional<int64_t> atime_in_ns = flatbuffers::nullopt;
+  if (with_times_) {
+    mtime_in_ns = dir.mtime_in_ns;
+    atime_in_ns = dir.atime_in_ns;
+  }
+  auto serde_dir = serde::CreateDir(fbb_,
+                                    dir.parent_id.val,
+                                    name,
+                                    dir.id.val,
+                                    acl,
+                                    dir.ctime_in_ns,
+                                    mtime_in_ns,
+                                    atime_in_ns);
+  fbb_.Finish(
+      serde::CreateInode(fbb_, serde::InodeType_Dir, serde_dir.Union()));
+  auto val = FinishedBuffer(fbb_);
+  if (ShouldVerifyOnWrite()) {
+    CHECK(Verify(val));
+  }
+  return val;
+}
+
+std::string_view InodeSerde::SerVal(const File& file) {
+  fbb_.Clear();
+  auto acl = CreateAcl(fbb_, file.acl);
+  auto serde_file = serde::CreateFile(fbb_, file.id.val, acl, file.ctime_in_ns);
+  fbb_.Finish(
+      serde::CreateInode(fbb_, serde::InodeType_File, serde_file.Union()));
+  auto val = FinishedBuffer(fbb_);
+  if (ShouldVerifyOnWrite()) {
+    CHECK(Verify(val));
+  }
+  return val;
 }
 
 InodeID InodeSerde::DeKey(std::string_view key) {
@@ -116,9 +187,9 @@ InodeID InodeSerde::DeKey(std::string_view key) {
 }
 
 std::variant<Dir, File> InodeSerde::DeVal(std::string_view val) {
-  CHECK(flatbuffers::Verifier(reinterpret_cast<const uint8_t*>(val.data()),
-                              val.size())
-            .VerifyBuffer<serde::Inode>());
+  if (ShouldVerifyOnRead()) {
+    CHECK(Verify(val));
+  }
   auto inode = flatbuffers::GetRoot<serde::Inode>(
       reinterpret_cast<const uint8_t*>(val.data()));
   if (auto dir = inode->type_as_Dir()) {
@@ -127,17 +198,27 @@ std::variant<Dir, File> InodeSerde::DeVal(std::string_view val) {
         .name =
             std::pmr::string(dir->name()->c_str(), dir->name()->size(), alloc_),
         .id = InodeID{dir->id()},
+        .acl = DeAcl(dir->acl()),
         .ctime_in_ns = dir->ctime_in_ns(),
+        .mtime_in_ns = dir->mtime_in_ns().value_or(0),
+        .atime_in_ns = dir->atime_in_ns().value_or(0),
     };
   }
   auto file = inode->type_as_File();
   CHECK_NOTNULL(file);
   return File{
       .id = InodeID{file->id()},
+      .acl = DeAcl(file->acl()),
       .ctime_in_ns = file->ctime_in_ns(),
   };
 }
 
+bool InodeSerde::Verify(std::string_view val) {
+  return flatbuffers::Verifier(reinterpret_cast<const uint8_t*>(val.data()),
+                               val.size())
+      .VerifyBuffer<serde::Inode>();
+}
+
 MTimeSerde::MTimeSerde(ReqScopedAlloc alloc) : alloc_(alloc), fb_alloc_(alloc) {
 }
 
@@ -157,15 +238,15 @@ bool MTimeSerde::IsValueChanged(const File& orig, const File& mod) const {
   return orig.mtime_in_ns != mod.mtime_in_ns;
 }
 
-std::pmr::string MTimeSerde::SerKey(InodeID id) {
-  return InodeSerde(alloc_).SerKey(id);
+KVKey MTimeSerde::SerKey(InodeID id) {
+  return KVKey(id);
 }
 
-std::pmr::string MTimeSerde::SerKey(const Dir& dir) {
+KVKey MTimeSerde::SerKey(const Dir& dir) {
   return SerKey(dir.id);
 }
 
-std::pmr::string MTimeSerde::SerKey(const File& file) {
+KVKey MTimeSerde::SerKey(const File& file) {
   return SerKey(file.id);
 }
 
@@ -208,15 +289,15 @@ bool ATimeSerde::IsValueChanged(const File& orig, const File& mod) const {
   return orig.atime_in_ns != mod.atime_in_ns;
 }
 
-std::pmr::string ATimeSerde::SerKey(InodeID id) {
-  return InodeSerde(alloc_).SerKey(id);
+KVKey ATimeSerde::SerKey(InodeID id) {
+  return KVKey(id);
 }
 
-std::pmr::string ATimeSerde::SerKey(const Dir& dir) {
+KVKey ATimeSerde::SerKey(const Dir& dir) {
   return SerKey(dir.id);
 }
 
-std::pmr::string ATimeSerde::SerKey(const File& file) {
+KVKey ATimeSerde::SerKey(const File& file) {
   return SerKey(file.id);
 }
 
@@ -240,7 +321,47 @@ int64_t ATimeSerde::DeVal(std::string_view val) {
   return absl::big_endian::Load64(val.data());
 }
 
-DEntSerde::DEntSerde(ReqScopedAlloc alloc) : alloc_(alloc), fb_alloc_(alloc) {
+TimesSerde::TimesSerde(ReqScopedAlloc alloc) : alloc_(alloc) {
+}
+
+bool TimesSerde::IsKeyChanged(const Dir& orig, const Dir& mod) const {
+  return orig.id != mod.id;
+}
+
+bool TimesSerde::IsValueChanged(const Dir& orig, const Dir& mod) const {
+  return orig.mtime_in_ns != mod.mtime_in_ns ||
+         orig.atime_in_ns != mod.atime_in_ns;
+}
+
+KVKey TimesSerde::SerKey(InodeID id) {
+  return KVKey(id);
+}
+
+KVKey TimesSerde::SerKey(const Dir& dir) {
+  return SerKey(dir.id);
+}
+
+std::pmr::string TimesSerde::SerVal(const Dir& dir) {
+  std::pmr::string times_str(alloc_);
+  times_str.resize(2 * sizeof(int64_t));
+  absl::big_endian::Store64(times_str.data(), dir.mtime_in_ns);
+  absl::big_endian::Store64(times_str.data() + sizeof(int64_t),
+                            dir.atime_in_ns);
+  return times_str;
+}
+
+std::tuple<int64_t, int64_t> TimesSerde::DeVal(std::string_view val) {
+  CHECK_EQ(val.size(), 2 * sizeof(int64_t));
+  return std::make_tuple(
+      static_cast<int64_t>(absl::big_endian::Load64(val.data())),
+      static_cast<int64_t>(
+          absl::big_endian::Load64(val.data() + sizeof(int64_t))));
+}
+
+DEntSerde::DEntSerde(ReqScopedAlloc alloc)
+    : alloc_(alloc),
+      fb_alloc_(alloc),
+      fbb_(kDefaultFlatBufferBuilderSize, &fb_alloc_) {
 }
 
 bool DEntSerde::IsKeyChanged(const Dir& orig, const Dir& mod) const {
@@ -252,7 +373,15 @@ bool DEntSerde::IsKeyChanged(const HardLink& orig, const HardLink& mod) const {
 }
 
 bool DEntSerde::IsValueChanged(const Dir& orig, const Dir& mod) const {
-  return orig.id != mod.id;
+  if (orig.id != mod.id || orig.acl != mod.acl ||
+      orig.ctime_in_ns != mod.ctime_in_ns) {
+    return true;
+  }
+  // Even while the times are not cached, a change of them rewrites the entry
+  // without them, so that no copy cached before stays behind to be served
+  // once caching is turned back on.
+  return orig.mtime_in_ns != mod.mtime_in_ns ||
+         orig.atime_in_ns != mod.atime_in_ns;
 }
 
 bool DEntSerde::IsValueChanged(const HardLink& orig,
@@ -260,49 +389,59 @@ bool DEntSerde::IsValueChanged(const HardLink& orig,
   return orig.id != mod.id;
 }
 
-std::pmr::string DEntSerde::SerKey(InodeID parent_id, std::string_view name) {
-  std::pmr::string key(alloc_);
-  key.resize(sizeof(InodeID) + name.size());
-  static_assert(sizeof(InodeID) == sizeof(int64_t));
-  absl::big_endian::Store64(key.data(), parent_id.val);
-  std::memcpy(key.data() + sizeof(InodeID), name.data(), name.size());
-  return key;
+KVKey DEntSerde::SerKey(InodeID parent_id, std::string_view name) {
+  return KVKey(parent_id, name);
 }
 
-std::pmr::string DEntSerde::SerKey(const Dir& dir) {
+KVKey DEntSerde::SerKey(const Dir& dir) {
   return SerKey(dir.parent_id, dir.name);
 }
 
-std::pmr::string DEntSerde::SerKey(const HardLink& hard_link) {
+KVKey DEntSerde::SerKey(const HardLink& hard_link) {
   return SerKey(hard_link.parent_id, hard_link.name);
 }
 
-DetachedBuffer DEntSerde::SerVal(const Dir& dir) {
-  serde::DirT serde_dir;
-  serde_dir.parent_id = dir.parent_id.val;
-  serde_dir.name = dir.name;
-  serde_dir.id = dir.id.val;
-  serde::DEntTypeUnion type;
-  type.Set(std::move(serde_dir));
-  serde::DEntT serde_dent;
-  serde_dent.type = std::move(type);
-  flatbuffers::FlatBufferBuilder fbb(kDefaultFlatBufferBuilderSize, &fb_alloc_);
-  fbb.Finish(serde::DEnt::Pack(fbb, &serde_dent));
-  return DetachedBuffer(fbb.Release());
-}
-
-DetachedBuffer DEntSerde::SerVal(const HardLink& hard_link) {
-  serde::HardLinkT serde_hard_link;
-  serde_hard_link.parent_id = hard_link.parent_id.val;
-  serde_hard_link.name = hard_link.name;
-  serde_hard_link.id = hard_link.id.val;
-  serde::DEntTypeUnion type;
-  type.Set(std::move(serde_hard_link));
-  serde::DEntT serde_dent;
-  serde_dent.type = std::move(type);
-  flatbuffers::FlatBufferBuilder fbb(kDefaultFlatBufferBuilderSize, &fb_alloc_);
-  fbb.Finish(serde::DEnt::Pack(fbb, &serde_dent));
-  return DetachedBuffer(fbb.Release());
+std::string_view DEntSerde::SerVal(const Dir& dir) {
+  fbb_.Clear();
+  auto name = fbb_.CreateString(dir.name.data(), dir.name.size());
+  auto acl = CreateAcl(fbb_, dir.acl);
+  // Everything `LookupOp` returns is stored here as well, so a lookup takes a
+  // single read. `KVDirTable::Write` keeps this copy in sync with the ones in
+  // the Inode, MTime and ATime column families within the same txn.
+  flatbuffers::Optional<int64_t> mtime_in_ns = flatbuffers::nullopt;
+  flatbuffers::Optional<int64_t> atime_in_ns = flatbuffers::nullopt;
+  if (FLAGS_dent_cache_dir_times) {
+    mtime_in_ns = dir.mtime_in_ns;
+    atime_in_ns = dir.atime_in_ns;
+  }
+  auto serde_dir = serde::CreateDir(fbb_,
+                                    dir.parent_id.val,
+                                    name,
+                                    dir.id.val,
+                                    acl,
+                                    dir.ctime_in_ns,
+                                    mtime_in_ns,
+                                    atime_in_ns);
+  fbb_.Finish(serde::CreateDEnt(fbb_, serde::DEntType_Dir, serde_dir.Union()));
+  auto val = FinishedBuffer(fbb_);
+  if (ShouldVerifyOnWrite()) {
+    CHECK(Verify(val));
+  }
+  return val;
+}
+
+std::string_view DEntSerde::SerVal(const HardLink& hard_link) {
+  fbb_.Clear();
+  auto name = fbb_.CreateString(hard_link.name.data(), hard_link.name.size());
+  auto serde_hard_link = serde::CreateHardLink(
+      fbb_, hard_link.parent_id.val, name, hard_link.id.val);
+  fbb_.Finish(serde::CreateDEnt(
+      fbb_, serde::DEntType_HardLink, serde_hard_link.Union()));
+  auto val = FinishedBuffer(fbb_);
+  if (ShouldVerifyOnWrite()) {
+    CHECK(Verify(val));
+  }
+  return val;
 }
 
 std::tuple<InodeID, std::pmr::string> DEntSerde::DeKey(std::string_view key) {
@@ -316,27 +455,34 @@ std::tuple<InodeID, std::pmr::string> DEntSerde::DeKey(std::string_view key) {
 }
 
 std::variant<Dir, HardLink> DEntSerde::DeVal(std::string_view val) {
-  CHECK(flatbuffers::Verifier(reinterpret_cast<const uint8_t*>(val.data()),
-                              val.size())
-            .VerifyBuffer<serde::DEnt>());
+  return std::visit(
+      [this](const auto& view) -> std::variant<Dir, HardLink> {
+        if constexpr (std::is_same_v<std::decay_t<decltype(view)>, KVDirView>) {
+          return view.ToDir(alloc_);
+        } else {
+          return view.ToHardLink(alloc_);
+        }
+      },
+      DeView(val));
+}
+
+std::variant<KVDirView, KVHardLinkView> DEntSerde::DeView(
+    std::string_view val) {
+  if (ShouldVerifyOnRead()) {
+    CHECK(Verify(val));
+  }
   auto dent = flatbuffers::GetRoot<serde::DEnt>(
       reinterpret_cast<const uint8_t*>(val.data()));
   if (auto dir = dent->type_as_Dir()) {
-    return Dir{
-        .parent_id = InodeID{dir->parent_id()},
-        .name =
-            std::pmr::string(dir->name()->c_str(), dir->name()->size(), alloc_),
-        .id = InodeID{dir->id()},
-    };
+    return KVDirView(dir, FLAGS_dent_cache_dir_times);
   }
-  auto hard_link = dent->type_as_HardLink();
-  CHECK_NOTNULL(hard_link);
-  return HardLink{
-      .parent_id = InodeID{hard_link->parent_id()},
-      .name = std::pmr::string(
-          hard_link->name()->c_str(), hard_link->name()->size(), alloc_),
-      .id = InodeID{hard_link->id()},
-  };
+  return KVHardLinkView(CHECK_NOTNULL(dent->type_as_HardLink()));
+}
+
+bool DEntSerde::Verify(std::string_view val) {
+  return flatbuffers::Verifier(reinterpret_cast<const uint8_t*>(val.data()),
+                               val.size())
+      .VerifyBuffer<serde::DEnt>();
 }
 
 }  // namespace rocketfs
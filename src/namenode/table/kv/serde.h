@@ -3,7 +3,7 @@
 #pragma once
 
 #include <flatbuffers/allocator.h>
-#include <flatbuffers/detached_buffer.h>
+#include <flatbuffers/flatbuffer_builder.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -18,11 +18,14 @@
 #include <variant>
 
 #include "namenode/common/req_scoped_alloc.h"
+#include "namenode/table/dent_view_base.h"
 #include "namenode/table/dir_table_base.h"
 #include "namenode/table/file_table_base.h"
 #include "namenode/table/hard_link_table_base.h"
 #include "namenode/table/inode_id.h"
 #include "namenode/table/kv/column_family.h"
+#include "namenode/table/kv/kv_dent_views.h"
+#include "namenode/table/kv/kv_key.h"
 #include "namenode/table/kv/kv_store_base.h"
 
 namespace rocketfs {
@@ -43,28 +46,26 @@ class FBAllocator : public flatbuffers::Allocator {
   std::allocator_traits<ReqScopedAlloc>::template rebind_alloc<uint8_t> alloc_;
 };
 
-// `DetachedBuffer` objects must not outlive their parent `Serde` instance.
-class DetachedBuffer {
- public:
-  DetachedBuffer(flatbuffers::DetachedBuffer&& buffer);
-  DetachedBuffer(const DetachedBuffer&) = delete;
-  DetachedBuffer(DetachedBuffer&& other) = default;
-  DetachedBuffer& operator=(const DetachedBuffer&) = delete;
-  DetachedBuffer& operator=(DetachedBuffer&& other) = default;
-  ~DetachedBuffer() = default;
-
-  operator std::string_view() const;
-
- private:
-  flatbuffers::DetachedBuffer buffer_;
+// How much `DeVal` trusts the bytes it decodes. See
+// `flatbuffer_verify_policy`.
+enum class FBVerifyPolicy : uint8_t {
+  kAlways,
+  kSampled,
+  kOnWrite,
 };
 
+FBVerifyPolicy GetFBVerifyPolicy();
+// Whether the value about to be decoded has to be verified first.
+bool ShouldVerifyOnRead();
+// Whether the value that was just serialized has to be verified.
+bool ShouldVerifyOnWrite();
+
 template <typename T>
   requires std::is_same_v<T, std::pmr::string> ||
-           std::is_same_v<T, DetachedBuffer>
+           std::is_same_v<T, std::string_view>
 struct WriteOps {
-  std::optional<std::pmr::string> del_key;
-  std::optional<std::pair<std::pmr::string, T>> put_kv;
+  std::optional<KVKey> del_key;
+  std::optional<std::pair<KVKey, T>> put_kv;
 };
 
 class Serde {
@@ -118,7 +119,9 @@ auto Serde::GetWriteOps(this auto&& self,
 
 class InodeSerde : public Serde {
  public:
-  explicit InodeSerde(ReqScopedAlloc alloc);
+  // With `with_times`, the mtime and atime of dirs are stored in the value as
+  // well, for `DirLayout::kCoLocated`.
+  explicit InodeSerde(ReqScopedAlloc alloc, bool with_times = false);
   InodeSerde(const InodeSerde&) = delete;
   InodeSerde(InodeSerde&&) = delete;
   InodeSerde& operator=(const InodeSerde&) = delete;
@@ -130,18 +133,29 @@ class InodeSerde : public Serde {
   bool IsValueChanged(const Dir& orig, const Dir& mod) const;
   bool IsValueChanged(const File& orig, const File& mod) const;
 
-  std::pmr::string SerKey(InodeID id);
-  std::pmr::string SerKey(const Dir& dir);
-  std::pmr::string SerKey(const File& file);
-  DetachedBuffer SerVal(const Dir& dir);
-  DetachedBuffer SerVal(const File& file);
+  KVKey SerKey(InodeID id);
+  KVKey SerKey(const Dir& dir);
+  KVKey SerKey(const File& file);
+  // The returned view points into `fbb_` and stays valid until the next
+  // `SerVal` call on this instance.
+  std::string_view SerVal(const Dir& dir);
+  std::string_view SerVal(const File& file);
 
   InodeID DeKey(std::string_view key);
+  // The mtime and atime of a dir are left as 0 unless stored in the value.
   std::variant<Dir, File> DeVal(std::string_view val);
 
+  static bool Verify(std::string_view val);
+
  private:
   ReqScopedAlloc alloc_;
+  bool with_times_;
   FBAllocator fb_alloc_;
+  // Values are built directly through `fbb_` rather than the object API, whose
+  // `std::string` and `std::unique_ptr` members allocate from the global heap.
+  // The builder is reused by every `SerVal` call, so its buffer is allocated
+  // from the req arena at most once per instance.
+  flatbuffers::FlatBufferBuilder fbb_;
 };
 
 class MTimeSerde : public Serde {
@@ -157,9 +171,9 @@ class MTimeSerde : public Serde {
   bool IsValueChanged(const Dir& orig, const Dir& mod) const;
   bool IsValueChanged(const File& orig, const File& mod) const;
 
-  std::pmr::string SerKey(InodeID id);
-  std::pmr::string SerKey(const Dir& dir);
-  std::pmr::string SerKey(const File& file);
+  KVKey SerKey(InodeID id);
+  KVKey SerKey(const Dir& dir);
+  KVKey SerKey(const File& file);
   std::pmr::string SerVal(int64_t mtime_in_ns);
   std::pmr::string SerVal(const Dir& dir);
   std::pmr::string SerVal(const File& file);
@@ -185,9 +199,9 @@ class ATimeSerde : public Serde {
   bool IsValueChanged(const Dir& orig, const Dir& mod) const;
   bool IsValueChanged(const File& orig, const File& mod) const;
 
-  std::pmr::string SerKey(InodeID id);
-  std::pmr::string SerKey(const Dir& dir);
-  std::pmr::string SerKey(const File& file);
+  KVKey SerKey(InodeID id);
+  KVKey SerKey(const Dir& dir);
+  KVKey SerKey(const File& file);
   std::pmr::string SerVal(int64_t atime_in_ns);
   std::pmr::string SerVal(const Dir& dir);
   std::pmr::string SerVal(const File& file);
@@ -199,6 +213,31 @@ class ATimeSerde : public Serde {
   FBAllocator fb_alloc_;
 };
 
+// Stores the mtime and atime of a dir together in a single value, for
+// `DirLayout::kHybrid`.
+class TimesSerde : public Serde {
+ public:
+  explicit TimesSerde(ReqScopedAlloc alloc);
+  TimesSerde(const TimesSerde&) = delete;
+  TimesSerde(TimesSerde&&) = delete;
+  TimesSerde& operator=(const TimesSerde&) = delete;
+  TimesSerde& operator=(TimesSerde&&) = delete;
+  ~TimesSerde() = default;
+
+  bool IsKeyChanged(const Dir& orig, const Dir& mod) const;
+  bool IsValueChanged(const Dir& orig, const Dir& mod) const;
+
+  KVKey SerKey(InodeID id);
+  KVKey SerKey(const Dir& dir);
+  std::pmr::string SerVal(const Dir& dir);
+
+  // Returns (mtime_in_ns, atime_in_ns).
+  std::tuple<int64_t, int64_t> DeVal(std::string_view val);
+
+ private:
+  ReqScopedAlloc alloc_;
+};
+
 class DEntSerde : public Serde {
  public:
   explicit DEntSerde(ReqScopedAlloc alloc);
@@ -213,18 +252,25 @@ class DEntSerde : public Serde {
   bool IsValueChanged(const Dir& orig, const Dir& mod) const;
   bool IsValueChanged(const HardLink& orig, const HardLink& mod) const;
 
-  std::pmr::string SerKey(InodeID parent_id, std::string_view name);
-  std::pmr::string SerKey(const Dir& dir);
-  std::pmr::string SerKey(const HardLink& file);
-  DetachedBuffer SerVal(const Dir& dir);
-  DetachedBuffer SerVal(const HardLink& hard_link);
+  KVKey SerKey(InodeID parent_id, std::string_view name);
+  KVKey SerKey(const Dir& dir);
+  KVKey SerKey(const HardLink& file);
+  // The returned view points into `fbb_` and stays valid until the next
+  // `SerVal` call on this instance.
+  std::string_view SerVal(const Dir& dir);
+  std::string_view SerVal(const HardLink& hard_link);
 
   std::tuple<InodeID, std::pmr::string> DeKey(std::string_view key);
   std::variant<Dir, HardLink> DeVal(std::string_view val);
+  // The returned view points into `val` and decodes fields on access.
+  std::variant<KVDirView, KVHardLinkView> DeView(std::string_view val);
+
+  static bool Verify(std::string_view val);
 
  private:
   ReqScopedAlloc alloc_;
   FBAllocator fb_alloc_;
+  flatbuffers::FlatBufferBuilder fbb_;
 };
 
 }  // namespace rocketfs
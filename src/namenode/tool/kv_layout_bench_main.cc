@@ -0,0 +1,229 @@
+// Copyright 2025 RocketFS
+
+// Runs the same dir workload against each `DirLayout` and reports the KV ops,
+// bytes and latency per op, e.g.,
+// ./kv_layout_bench --kv_layout_bench_dirs=100000 --kv_layout_bench_ops=100000
+
+#include <absl/strings/str_split.h>
+#include <fmt/core.h>
+#include <gflags/gflags.h>
+#include <quill/core/LogLevel.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <unifex/sync_wait.hpp>
+#include <unifex/task.hpp>
+
+#include "common/logger.h"
+#include "common/time_util.h"
+#include "namenode/common/req_scoped_alloc.h"
+#include "namenode/table/dir_table_base.h"
+#include "namenode/table/inode_id.h"
+#include "namenode/table/kv/kv_dir_table.h"
+#include "namenode/table/kv/kv_store_base.h"
+#include "namenode/table/kv/layout.h"
+#include "namenode/table/kv/rocksdb_kv_store.h"
+
+DEFINE_string(kv_layout_bench_layouts,
+              "split,co_located,hybrid",
+              "The comma-separated dir layouts to compare.");
+DEFINE_string(kv_layout_bench_db_path,
+              "/tmp/rocketfs_kv_layout_bench",
+              "A fresh database is created under this path for each layout.");
+DEFINE_uint64(kv_layout_bench_dirs,
+              100'000,
+              "The num of dirs created before the read and update phases.");
+DEFINE_uint64(kv_layout_bench_ops,
+              100'000,
+              "The num of ops in each read and update phase.");
+DEFINE_uint32(kv_layout_bench_arena_bytes,
+              64 * 1024,
+              "The size of the arena each simulated req runs in.");
+
+namespace rocketfs {
+
+constexpr uint64_t kFirstBenchInodeID = 1ULL << 40;
+
+struct PhaseResult {
+  uint64_t ops{0};
+  KVStats stats;
+  int64_t elapsed_ns{0};
+};
+
+void Accumulate(const KVStats& from, KVStats* to) {
+  to->gets += from.gets;
+  to->multi_gets += from.multi_gets;
+  to->range_gets += from.range_gets;
+  to->keys_read += from.keys_read;
+  to->bytes_read += from.bytes_read;
+  to->puts += from.puts;
+  to->dels += from.dels;
+  to->bytes_written += from.bytes_written;
+}
+
+Dir MakeDir(uint64_t i, ReqScopedAlloc alloc) {
+  constexpr int64_t kNowNs = 1'742'256'000'000'000'000;
+  return Dir{.parent_id = kRootInodeID,
+             .name = std::pmr::string(fmt::format("dir-{:010}", i), alloc),
+             .id = InodeID{kFirstBenchInodeID + i},
+             .acl = {.uid = 1000, .gid = 1000, .perm = 0755},
+             .ctime_in_ns = kNowNs,
+             .mtime_in_ns = kNowNs,
+             .atime_in_ns = kNowNs};
+}
+
+// Runs `op` in its own arena and txn, as a req would, and commits the txn if it
+// wrote anything.
+template <typename Op>
+void RunOp(KVStoreBase* kv_store,
+           DirLayout layout,
+           std::byte* arena_holder,
+           Op&& op,
+           PhaseResult* result) {
+  auto start = std::chrono::steady_clock::now();
+  std::pmr::monotonic_buffer_resource arena(arena_holder,
+                                            FLAGS_kv_layout_bench_arena_bytes);
+  ReqScopedAlloc alloc(&arena);
+  auto txn = kv_store->StartTxn(alloc);
+  {
+    KVDirTable dir_table(txn.get(), alloc, layout);
+    unifex::sync_wait(op(&dir_table, alloc));
+  }
+  const auto& stats = txn->GetStats();
+  Accumulate(stats, &result->stats);
+  if (stats.puts + stats.dels > 0) {
+    auto committed = unifex::sync_wait(kv_store->CommitTxn(std::move(txn)));
+    CHECK(committed && *committed);
+  }
+  result->elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  result->ops++;
+}
+
+void PrintPhase(DirLayout layout,
+                std::string_view phase,
+                const PhaseResult& result) {
+  auto per_op = [&result](uint64_t n) {
+    return static_cast<double>(n) / result.ops;
+  };
+  fmt::print("{:<12} {:<8} {:>6.2f} gets/op {:>6.2f} keys read/op {:>7.1f} "
+             "bytes read/op {:>6.2f} writes/op {:>7.1f} bytes written/op "
+             "{:>8.2f} us/op\n",
+             DirLayoutName(layout),
+             phase,
+             per_op(result.stats.gets + result.stats.multi_gets +
+                    result.stats.range_gets),
+             per_op(result.stats.keys_read),
+             per_op(result.stats.bytes_read),
+             per_op(result.stats.puts + result.stats.dels),
+             per_op(result.stats.bytes_written),
+             per_op(result.elapsed_ns) / kUsToNs);
+}
+
+void Bench(DirLayout layout) {
+  auto db_path = std::filesystem::path(FLAGS_kv_layout_bench_db_path) /
+                 std::string(DirLayoutName(layout));
+  std::filesystem::remove_all(db_path);
+  std::filesystem::create_directories(db_path);
+  auto kv_store = std::make_unique<RocksDBKVStore>(db_path.string());
+  auto arena_holder =
+      std::make_unique<std::byte[]>(FLAGS_kv_layout_bench_arena_bytes);
+  CHECK_GT(FLAGS_kv_layout_bench_dirs, 0);
+  std::mt19937_64 rng(FLAGS_kv_layout_bench_dirs);
+  std::uniform_int_distribution<uint64_t> dist(0,
+                                               FLAGS_kv_layout_bench_dirs - 1);
+
+  PhaseResult mkdir;
+  for (uint64_t i = 0; i < FLAGS_kv_layout_bench_dirs; i++) {
+    RunOp(
+        kv_store.get(),
+        layout,
+        arena_holder.get(),
+        [i](DirTableBase* dir_table,
+            ReqScopedAlloc alloc) -> unifex::task<void> {
+          dir_table->Write(std::nullopt, MakeDir(i, alloc));
+          co_return;
+        },
+        &mkdir);
+  }
+  PrintPhase(layout, "mkdir", mkdir);
+
+  PhaseResult getattr;
+  for (uint64_t n = 0; n < FLAGS_kv_layout_bench_ops; n++) {
+    RunOp(
+        kv_store.get(),
+        layout,
+        arena_holder.get(),
+        [i = dist(rng)](DirTableBase* dir_table,
+                        ReqScopedAlloc alloc) -> unifex::task<void> {
+          auto dir =
+              co_await dir_table->Read(InodeID{kFirstBenchInodeID + i});
+          CHECK(dir && *dir);
+        },
+        &getattr);
+  }
+  PrintPhase(layout, "getattr", getattr);
+
+  PhaseResult lookup;
+  for (uint64_t n = 0; n < FLAGS_kv_layout_bench_ops; n++) {
+    RunOp(
+        kv_store.get(),
+        layout,
+        arena_holder.get(),
+        [i = dist(rng)](DirTableBase* dir_table,
+                        ReqScopedAlloc alloc) -> unifex::task<void> {
+          auto dir = co_await dir_table->Read(kRootInodeID,
+                                              MakeDir(i, alloc).name);
+          CHECK(dir && *dir);
+        },
+        &lookup);
+  }
+  PrintPhase(layout, "lookup", lookup);
+
+  PhaseResult touch;
+  for (uint64_t n = 0; n < FLAGS_kv_layout_bench_ops; n++) {
+    RunOp(
+        kv_store.get(),
+        layout,
+        arena_holder.get(),
+        [i = dist(rng), n](DirTableBase* dir_table,
+                           ReqScopedAlloc alloc) -> unifex::task<void> {
+          auto dir =
+              co_await dir_table->Read(InodeID{kFirstBenchInodeID + i});
+          CHECK(dir && *dir);
+          auto touched = **dir;
+          touched.mtime_in_ns += n + 1;
+          touched.atime_in_ns += n + 1;
+          dir_table->Write(*dir, touched);
+        },
+        &touch);
+  }
+  PrintPhase(layout, "touch", touch);
+}
+
+}  // namespace rocketfs
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  // Per-txn debug logs would dominate the measured latency.
+  rocketfs::logger->set_log_level(quill::LogLevel::Warning);
+  for (std::string_view name :
+       absl::StrSplit(FLAGS_kv_layout_bench_layouts, ',')) {
+    auto layout = rocketfs::ParseDirLayout(name);
+    rocketfs::Check(static_cast<bool>(layout),
+                    fmt::format("Unknown layout {}", name));
+    rocketfs::Bench(*layout);
+  }
+  return 0;
+}
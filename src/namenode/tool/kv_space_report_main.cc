@@ -0,0 +1,174 @@
+// Copyright 2025 RocketFS
+
+// Reports how many bytes the namespace takes per column family and per inode,
+// including whether zstd dictionaries were used, e.g.,
+// ./kv_space_report --rocksdb_kv_store_db_path=/tmp/rocksdb \
+//     --kv_space_report_compact
+//
+// RocksDB keeps blocks uncompressed in its block cache, so the on-disk bytes
+// size the OS page cache while the uncompressed bytes size the block cache.
+// The report also reads the Inode and DEnt CFs through their block cache and
+// prints how many bytes per inode it then holds. Whatever exceeds
+// `rocksdb_block_cache_bytes` spills into the compressed secondary cache.
+
+#include <fmt/core.h>
+#include <gflags/gflags.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/db.h>
+#include <rocksdb/iterator.h>
+#include <rocksdb/options.h>
+#include <rocksdb/status.h>
+#include <rocksdb/table_properties.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/logger.h"
+#include "namenode/table/kv/column_family.h"
+#include "namenode/table/kv/rocksdb_kv_store.h"
+
+DEFINE_bool(kv_space_report_compact,
+            false,
+            "Fully compact every column family before reporting, so that "
+            "every value is in an SST file compressed with the current "
+            "options. Opens the database for writing.");
+
+namespace rocketfs {
+
+DECLARE_string(rocksdb_kv_store_db_path);
+
+struct CFSpace {
+  uint64_t entries{0};
+  uint64_t raw_bytes{0};
+  uint64_t uncompressed_block_bytes{0};
+  uint64_t sst_bytes{0};
+  std::string compression;
+};
+
+CFSpace GetCFSpace(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* cf_handle) {
+  CFSpace space;
+  rocksdb::TablePropertiesCollection props;
+  auto status = db->GetPropertiesOfAllTables(cf_handle, &props);
+  Check(status.ok(), status.ToString());
+  for (const auto& [file, prop] : props) {
+    space.entries += prop->num_entries - prop->num_deletions;
+    space.raw_bytes += prop->raw_key_size + prop->raw_value_size;
+    space.uncompressed_block_bytes += prop->raw_key_size +
+                                      prop->raw_value_size + prop->index_size +
+                                      prop->filter_size;
+    if (space.compression.empty()) {
+      space.compression = fmt::format(
+          "{} {}", prop->compression_name, prop->compression_options);
+    }
+  }
+  CHECK(db->GetIntProperty(cf_handle,
+                           rocksdb::DB::Properties::kTotalSstFilesSize,
+                           &space.sst_bytes));
+  return space;
+}
+
+// Reads every entry of `cf_handle` through the block cache.
+void WarmBlockCache(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* cf_handle) {
+  auto iter = std::unique_ptr<rocksdb::Iterator>(
+      db->NewIterator(rocksdb::ReadOptions(), cf_handle));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+  }
+  Check(iter->status().ok(), iter->status().ToString());
+}
+
+double PerEntry(uint64_t bytes, uint64_t entries) {
+  return entries == 0 ? 0 : static_cast<double>(bytes) / entries;
+}
+
+void Report() {
+  auto cf_descriptors = RocksDBCFDescriptors();
+  std::vector<rocksdb::ColumnFamilyHandle*> cf_handles;
+  rocksdb::DB* raw_db = nullptr;
+  rocksdb::Status status;
+  if (FLAGS_kv_space_report_compact) {
+    status = rocksdb::DB::Open(rocksdb::DBOptions(),
+                               FLAGS_rocksdb_kv_store_db_path,
+                               cf_descriptors,
+                               &cf_handles,
+                               &raw_db);
+  } else {
+    status = rocksdb::DB::OpenForReadOnly(rocksdb::DBOptions(),
+                                          FLAGS_rocksdb_kv_store_db_path,
+                                          cf_descriptors,
+                                          &cf_handles,
+                                          &raw_db);
+  }
+  Check(status.ok(), status.ToString());
+  auto db = std::unique_ptr<rocksdb::DB>(raw_db);
+
+  if (FLAGS_kv_space_report_compact) {
+    rocksdb::CompactRangeOptions compact_options;
+    compact_options.bottommost_level_compaction =
+        rocksdb::BottommostLevelCompaction::kForce;
+    for (auto* cf_handle : cf_handles) {
+      CHECK(db->Flush(rocksdb::FlushOptions(), cf_handle).ok());
+      CHECK(
+          db->CompactRange(compact_options, cf_handle, nullptr, nullptr).ok());
+    }
+  }
+
+  fmt::print("{:<16} {:>12} {:>10} {:>14} {:>12} {:>12}  {}\n",
+             "CF",
+             "Entries",
+             "Raw B/ent",
+             "Uncompr B/ent",
+             "Disk B/ent",
+             "Disk bytes",
+             "Compression");
+  uint64_t inodes = 0;
+  uint64_t total_uncompressed_bytes = 0;
+  uint64_t total_sst_bytes = 0;
+  for (size_t i = 0; i < cf_handles.size(); i++) {
+    auto space = GetCFSpace(db.get(), cf_handles[i]);
+    fmt::print("{:<16} {:>12} {:>10.1f} {:>14.1f} {:>12.1f} {:>12}  {}\n",
+               cf_handles[i]->GetName(),
+               space.entries,
+               PerEntry(space.raw_bytes, space.entries),
+               PerEntry(space.uncompressed_block_bytes, space.entries),
+               PerEntry(space.sst_bytes, space.entries),
+               space.sst_bytes,
+               space.compression);
+    if (static_cast<int8_t>(i) == kInodeCFIndex.index) {
+      inodes = space.entries;
+    }
+    total_uncompressed_bytes += space.uncompressed_block_bytes;
+    total_sst_bytes += space.sst_bytes;
+  }
+  fmt::print("\n{} inodes, {:.1f} uncompressed bytes/inode (block cache), "
+             "{:.1f} on-disk bytes/inode (page cache)\n",
+             inodes,
+             PerEntry(total_uncompressed_bytes, inodes),
+             PerEntry(total_sst_bytes, inodes));
+
+  auto block_cache = GetFlatBufferBlockCache();
+  WarmBlockCache(db.get(), cf_handles[kInodeCFIndex.index]);
+  WarmBlockCache(db.get(), cf_handles[kDEntCFIndex.index]);
+  auto cached_bytes = block_cache->GetUsage();
+  fmt::print("{:.1f} block cache bytes/inode ({} of {} bytes){}\n",
+             PerEntry(cached_bytes, inodes),
+             cached_bytes,
+             block_cache->GetCapacity(),
+             cached_bytes < block_cache->GetCapacity()
+                 ? ""
+                 : ", the rest spilled into the compressed cache");
+
+  for (auto* cf_handle : cf_handles) {
+    CHECK(db->DestroyColumnFamilyHandle(cf_handle).ok());
+  }
+}
+
+}  // namespace rocketfs
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  rocketfs::Report();
+  return 0;
+}
@@ -0,0 +1,225 @@
+// Copyright 2025 RocketFS
+
+// Starts a namenode in process with each num of gRPC threads in turn and
+// reports the QPS of PingPong, Mkdirs, GetInode and Lookup, e.g.,
+// ./namenode_qps_bench --namenode_qps_bench_threads=1,2,4,8 \
+//     --namenode_qps_bench_clients=64 --namenode_pin_grpc_threads
+//
+// The clients run in the same process, so leave them enough CPUs of their own
+// for the server side to be the bottleneck. PingPong touches neither the arena
+// nor KV, so it measures the fixed cost of a req.
+
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_split.h>
+#include <fmt/core.h>
+#include <gflags/gflags.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+#include <grpcpp/support/channel_arguments.h>
+#include <grpcpp/support/status.h>
+#include <quill/core/LogLevel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "common/logger.h"
+#include "namenode/namenode_ctx.h"
+#include "namenode/service/namenode_server.h"
+#include "namenode/table/inode_id.h"
+#include "src/proto/client_namenode.grpc.pb.h"
+#include "src/proto/client_namenode.pb.h"
+
+DEFINE_string(namenode_qps_bench_threads,
+              "1,2,4,8",
+              "The comma-separated nums of gRPC threads to run the server "
+              "with.");
+DEFINE_string(namenode_qps_bench_db_path,
+              "/tmp/rocketfs_namenode_qps_bench",
+              "A fresh database is created under this path for each run.");
+DEFINE_uint32(namenode_qps_bench_port, 50151, "The port the server binds.");
+DEFINE_uint32(namenode_qps_bench_clients,
+              64,
+              "The num of client threads, each with its own connection.");
+DEFINE_uint32(namenode_qps_bench_seconds, 5, "How long each phase runs.");
+
+namespace rocketfs {
+
+DECLARE_string(rocksdb_kv_store_db_path);
+DECLARE_uint32(namenode_grpc_threads);
+
+struct CreatedDir {
+  uint64_t id;
+  std::string name;
+};
+
+struct PhaseResult {
+  uint64_t ops{0};
+  uint64_t errors{0};
+  double seconds{0};
+};
+
+// Runs `op(client, n, stub)` back to back on every client for
+// `namenode_qps_bench_seconds`; `op` returns false on failure.
+template <typename Op>
+PhaseResult RunPhase(
+    const std::vector<std::unique_ptr<ClientNamenodeService::Stub>>& stubs,
+    Op&& op) {
+  std::atomic<uint64_t> ops{0};
+  std::atomic<uint64_t> errors{0};
+  auto start = std::chrono::steady_clock::now();
+  auto deadline =
+      start + std::chrono::seconds(FLAGS_namenode_qps_bench_seconds);
+  std::vector<std::thread> clients;
+  for (size_t client = 0; client < stubs.size(); client++) {
+    clients.emplace_back([&, client]() {
+      uint64_t n = 0;
+      uint64_t failed = 0;
+      for (; std::chrono::steady_clock::now() < deadline; n++) {
+        if (!op(client, n, stubs[client].get())) {
+          failed++;
+        }
+      }
+      ops += n;
+      errors += failed;
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  return PhaseResult{
+      .ops = ops,
+      .errors = errors,
+      .seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()};
+}
+
+void PrintPhase(uint32_t threads,
+                std::string_view phase,
+                const PhaseResult& result) {
+  fmt::print("{:>8} {:<10} {:>12.0f} QPS {:>10.1f} us/op {:>8} errors\n",
+             threads,
+             phase,
+             result.ops / result.seconds,
+             result.seconds * FLAGS_namenode_qps_bench_clients * 1e6 /
+                 std::max<uint64_t>(result.ops, 1),
+             result.errors);
+}
+
+void Bench(uint32_t threads) {
+  auto db_path = std::filesystem::path(FLAGS_namenode_qps_bench_db_path) /
+                 fmt::format("threads-{}", threads);
+  std::filesystem::remove_all(db_path);
+  std::filesystem::create_directories(db_path);
+  FLAGS_rocksdb_kv_store_db_path = db_path.string();
+  FLAGS_namenode_grpc_threads = threads;
+
+  auto namenode_ctx = std::make_unique<NameNodeCtx>();
+  namenode_ctx->Start();
+  auto address = fmt::format("127.0.0.1:{}", FLAGS_namenode_qps_bench_port);
+  auto server = std::make_unique<NameNodeServer>(namenode_ctx.get());
+  server->Start(address);
+
+  std::vector<std::unique_ptr<ClientNamenodeService::Stub>> stubs;
+  for (uint32_t i = 0; i < FLAGS_namenode_qps_bench_clients; i++) {
+    // Otherwise channels to the same address share one connection, and the
+    // server would see a single client.
+    grpc::ChannelArguments args;
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    stubs.emplace_back(ClientNamenodeService::NewStub(grpc::CreateCustomChannel(
+        address, grpc::InsecureChannelCredentials(), args)));
+  }
+
+  PrintPhase(threads,
+             "PingPong",
+             RunPhase(stubs, [&](size_t client, uint64_t n, auto* stub) {
+               grpc::ClientContext ctx;
+               PingRequest req;
+               PongResponse resp;
+               return stub->PingPong(&ctx, req, &resp).ok();
+             }));
+
+  std::vector<std::vector<CreatedDir>> created(stubs.size());
+  PrintPhase(
+      threads,
+      "Mkdirs",
+      RunPhase(stubs, [&](size_t client, uint64_t n, auto* stub) {
+        grpc::ClientContext ctx;
+        MkdirsRequest req;
+        req.set_parent_id(kRootInodeID.val);
+        req.set_name(fmt::format("c{}-{}", client, n));
+        req.set_mode(0755);
+        MkdirsResponse resp;
+        if (!stub->Mkdirs(&ctx, req, &resp).ok() || resp.error_code() != 0) {
+          return false;
+        }
+        created[client].push_back(
+            CreatedDir{.id = resp.id(), .name = req.name()});
+        return true;
+      }));
+  for (const auto& dirs : created) {
+    CHECK(!dirs.empty());
+  }
+
+  PrintPhase(threads,
+             "GetInode",
+             RunPhase(stubs, [&](size_t client, uint64_t n, auto* stub) {
+               const auto& dir = created[client][n % created[client].size()];
+               grpc::ClientContext ctx;
+               GetInodeRequest req;
+               req.set_id(dir.id);
+               GetInodeResponse resp;
+               return stub->GetInode(&ctx, req, &resp).ok() &&
+                      resp.error_code() == 0;
+             }));
+
+  PrintPhase(threads,
+             "Lookup",
+             RunPhase(stubs, [&](size_t client, uint64_t n, auto* stub) {
+               const auto& dir = created[client][n % created[client].size()];
+               grpc::ClientContext ctx;
+               LookupRequest req;
+               req.set_parent_id(kRootInodeID.val);
+               req.set_name(dir.name);
+               LookupResponse resp;
+               return stub->Lookup(&ctx, req, &resp).ok() &&
+                      resp.error_code() == 0;
+             }));
+
+  stubs.clear();
+  server->Shutdown();
+  server->Wait();
+  server.reset();
+  namenode_ctx->Stop();
+}
+
+}  // namespace rocketfs
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  // Per-req debug logs would dominate the measured latency.
+  rocketfs::logger->set_log_level(quill::LogLevel::Warning);
+  fmt::print("{:>8} {:<10} {:>16} {:>16} {:>15}\n",
+             "Threads",
+             "RPC",
+             "Throughput",
+             "Latency",
+             "Errors");
+  for (std::string_view threads :
+       absl::StrSplit(FLAGS_namenode_qps_bench_threads, ',')) {
+    uint32_t n = 0;
+    rocketfs::Check(absl::SimpleAtoi(threads, &n) && n > 0,
+                    fmt::format("Invalid num of threads {}", threads));
+    rocketfs::Bench(n);
+  }
+  return 0;
+}
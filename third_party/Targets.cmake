@@ -5,6 +5,7 @@ list(
   ${CMAKE_CURRENT_LIST_DIR}
   ${CMAKE_CURRENT_LIST_DIR}/abseil/lib/cmake/absl
   ${CMAKE_CURRENT_LIST_DIR}/asio-grpc/lib/cmake/asio-grpc
+  ${CMAKE_CURRENT_LIST_DIR}/benchmark/lib/cmake/benchmark
   ${CMAKE_CURRENT_LIST_DIR}/curl/lib/cmake/CURL
   ${CMAKE_CURRENT_LIST_DIR}/flatbuffers/lib/cmake/flatbuffers
   ${CMAKE_CURRENT_LIST_DIR}/fmt/lib/cmake/fmt